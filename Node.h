@@ -22,38 +22,35 @@ public:
 		type = "uninitialised";
 		value = "uninitialised"; }   // Bison needs this.
   
-	void print_tree(int depth=0) {
-		for(int i=0; i<depth; i++)
-		cout << "  ";
-		cout << type << ":" << value << endl; //<< " @line: "<< lineno << endl;
-		for(auto i=children.begin(); i!=children.end(); i++)
-		(*i)->print_tree(depth+1);
-	}
-  
-	void generate_tree() {
+	// Prints the tree to stdout and writes it to tree.dot in a single walk
+	void print_and_generate_tree() {
 		std::ofstream outStream;
 		char* filename = "tree.dot";
 	  	outStream.open(filename);
 
 		int count = 0;
 		outStream << "digraph {" << std::endl;
-		generate_tree_content(count, &outStream);
+		print_and_generate_tree_content(0, count, &outStream);
 		outStream << "}" << std::endl;
 		outStream.close();
 
 		printf("\nBuilt a parse-tree at %s. Use 'make tree' to generate the pdf version.\n", filename);
-  	}
+	}
+
+	void print_and_generate_tree_content(int depth, int &count, ofstream *outStream) {
+	  for(int i=0; i<depth; i++)
+	  cout << "  ";
+	  cout << type << ":" << value << endl;
 
-  	void generate_tree_content(int &count, ofstream *outStream) {
 	  id = count++;
 	  *outStream << "n" << id << " [label=\"" << type << ":" << value << "\"];" << endl;
 
 	  for (auto i = children.begin(); i != children.end(); i++)
 	  {
-		  (*i)->generate_tree_content(count, outStream);
+		  (*i)->print_and_generate_tree_content(depth+1, count, outStream);
 		  *outStream << "n" << id << " -> n" << (*i)->id << endl;
 	  }
-  }
+	}
 
 };
 
@@ -0,0 +1,114 @@
+#include "classlayout.h"
+
+Node* findChild(Node* node, const std::string& type) {
+    for (auto child : node->children) {
+        if (child->type == type) return child;
+    }
+    return nullptr;
+}
+
+bool isReferenceType(const std::string& type) {
+    return type != "int" && type != "boolean";
+}
+
+bool parseIntLiteral(const std::string& text, int64_t& value) {
+    // The lexer only passes digits, so stopping past INT32_MAX is the one check needed
+    value = 0;
+    for (char digit : text) {
+        value = value * 10 + (digit - '0');
+        if (value > INT32_MAX) return false;
+    }
+    return !text.empty();
+}
+
+int ClassLayout::findField(const std::string& fieldName, std::string& type) const {
+    // Search from the most derived declaration so hidden fields resolve to the subclass
+    for (int i = (int)fields.size() - 1; i >= 0; --i) {
+        if (fields[i].first == fieldName) {
+            type = fields[i].second;
+            return i;
+        }
+    }
+    return -1;
+}
+
+const MethodInfo* ClassLayout::findMethod(const std::string& methodName, int& index) const {
+    for (size_t i = 0; i < vtable.size(); ++i) {
+        if (vtable[i].name == methodName) {
+            index = i;
+            return &vtable[i];
+        }
+    }
+    return nullptr;
+}
+
+namespace {
+
+bool layOut(ClassLayouts& classes, ClassLayout& layout, size_t depth, std::string& error, int& errorLine) {
+    if (layout.laidOut) return true;
+    if (depth > classes.size()) {
+        error = "cyclic inheritance involving class '" + layout.name + "'";
+        errorLine = layout.node->lineno;
+        return false;
+    }
+
+    if (!layout.parentClass.empty()) {
+        auto parent = classes.find(layout.parentClass);
+        if (parent == classes.end()) {
+            error = "undefined parent class '" + layout.parentClass + "'";
+            errorLine = layout.node->lineno;
+            return false;
+        }
+        if (!layOut(classes, parent->second, depth + 1, error, errorLine)) return false;
+        layout.fields = parent->second.fields;
+        layout.references = parent->second.references;
+        layout.vtable = parent->second.vtable;
+    }
+
+    Node* fields = findChild(layout.node, "VarDeclarationList");
+    if (fields) {
+        for (auto field : fields->children) {
+            layout.fields.emplace_back(field->value, field->children.front()->value);
+        }
+    }
+    for (size_t i = layout.references.size(); i < layout.fields.size(); ++i) {
+        layout.references.push_back(isReferenceType(layout.fields[i].second));
+    }
+
+    Node* methods = findChild(layout.node, "MethodDeclarationList");
+    if (methods) {
+        for (auto method : methods->children) {
+            MethodInfo info{method->value, layout.name, method->children.front()->value, method};
+            bool overridden = false;
+            for (auto& slot : layout.vtable) {
+                if (slot.name == info.name) {
+                    slot = info;
+                    overridden = true;
+                }
+            }
+            if (!overridden) layout.vtable.push_back(info);
+        }
+    }
+    layout.laidOut = true;
+    return true;
+}
+
+} // namespace
+
+bool buildClassLayouts(Node* root, ClassLayouts& classes, std::string& error, int& errorLine) {
+    Node* list = findChild(root, "ClassDeclarationList");
+    if (!list) return true;
+
+    for (auto classNode : list->children) {
+        ClassLayout& layout = classes[classNode->value];
+        layout.name = classNode->value;
+        layout.node = classNode;
+        Node* extends = findChild(classNode, "Extends");
+        if (extends) layout.parentClass = extends->value;
+    }
+
+    for (auto& entry : classes) {
+        if (!layOut(classes, entry.second, 0, error, errorLine)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef CLASSLAYOUT_H
+#define CLASSLAYOUT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Node.h"
+
+// A method as seen through a class's vtable
+struct MethodInfo {
+    std::string name;
+    std::string ownerClass; // Class whose body defines the method
+    std::string returnType;
+    Node* node;
+};
+
+// Runtime layout of a class: its fields and its vtable, both including inherited entries
+struct ClassLayout {
+    std::string name;
+    std::string parentClass;
+    Node* node = nullptr;
+    bool laidOut = false;
+    std::vector<std::pair<std::string, std::string>> fields; // (name, type), inherited fields first
+    std::vector<bool> references;                             // Fields declared with a class or array type
+    std::vector<MethodInfo> vtable;                           // Inherited slots first, overrides replace them
+
+    // Index of a field in 'fields' (-1 if missing), resolving hidden fields to the subclass
+    int findField(const std::string& fieldName, std::string& type) const;
+    // Vtable entry for a method (nullptr if missing)
+    const MethodInfo* findMethod(const std::string& methodName, int& index) const;
+};
+
+typedef std::unordered_map<std::string, ClassLayout> ClassLayouts;
+
+// Lays out every class declared under 'root'. On an undefined parent or an
+// inheritance cycle it returns false and describes the problem in error/errorLine.
+bool buildClassLayouts(Node* root, ClassLayouts& classes, std::string& error, int& errorLine);
+
+// True for class and array types, whose values point into the heap
+bool isReferenceType(const std::string& type);
+
+// First direct child of 'node' with the given type, or nullptr
+Node* findChild(Node* node, const std::string& type);
+
+// Value of an integer literal, false if it does not fit in a Java int
+bool parseIntLiteral(const std::string& text, int64_t& value);
+
+#endif // CLASSLAYOUT_H
@@ -0,0 +1,664 @@
+#include "codegen.h"
+#include "classlayout.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// System V integer argument registers, 'this' goes in the first one
+const char* ARG_REGISTERS[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
+const int ARG_REGISTER_COUNT = 6;
+
+// Callee-saved registers that frame slots are allocated to, so they survive calls
+const char* SAVED_REGISTERS[] = {"%rbx", "%r12", "%r13", "%r14", "%r15"};
+const int SAVED_REGISTER_COUNT = 5;
+
+// Positions in a method, in evaluation order, where a frame slot must hold its value
+struct LiveInterval {
+    int slot;
+    int start;
+    int end;
+    double weight; // Uses of the slot, each counting ten times more per enclosing loop
+};
+
+class CodeGenerator {
+public:
+    explicit CodeGenerator(const SymbolTable& symbolTable) : symbolTable(symbolTable) {}
+
+    bool generate(Node* root, std::ostream& out) {
+        std::string error;
+        int errorLine = 0;
+        if (!buildClassLayouts(root, classes, error, errorLine)) {
+            std::cerr << "Code generation error at line " << errorLine << ": " << error << std::endl;
+            return false;
+        }
+
+        text << "\t.text\n";
+        for (auto child : root->children) {
+            if (child->type == "MainClass") {
+                generateMain(child);
+            } else if (child->type == "ClassDeclarationList") {
+                for (auto classNode : child->children) {
+                    currentClass = classNode->value;
+                    Node* methods = findChild(classNode, "MethodDeclarationList");
+                    if (!methods) continue;
+                    for (auto method : methods->children) {
+                        generateMethod(method);
+                    }
+                }
+            }
+        }
+
+        // One vtable per class, in the order of its method slots
+        text << "\n\t.section .data.rel.ro\n";
+        for (const auto& entry : classes) {
+            text << "\t.p2align 3\n" << vtableLabel(entry.first) << ":\n";
+            for (const auto& method : entry.second.vtable) {
+                text << "\t.quad " << methodLabel(method.ownerClass, method.name) << "\n";
+            }
+            if (entry.second.vtable.empty()) {
+                text << "\t.quad 0\n";
+            }
+        }
+        text << "\t.section .note.GNU-stack,\"\",@progbits\n";
+
+        if (ok) out << text.str();
+        return ok;
+    }
+
+private:
+    const SymbolTable& symbolTable;
+    ClassLayouts classes;
+    std::ostringstream text;
+    bool ok = true;
+    int labelCount = 0;
+
+    // State of the method being generated
+    std::string currentClass;
+    const FrameLayout* frame = nullptr; // Slots of the parameters and locals, from the symbol table
+    int pushDepth = 0; // Temporaries pushed since the prologue, for call alignment
+    std::string boundsLabel;
+    std::string nullLabel;
+    std::vector<int> slotRegisters;  // Index in SAVED_REGISTERS of each slot, -1 if it stays in memory
+    std::vector<int> savedRegisters; // Registers the method uses, saved after the slots
+
+    void fail(Node* node, const std::string& message) {
+        if (ok) {
+            std::cerr << "Code generation error at line " << (node ? node->lineno : 0) << ": " << message << std::endl;
+        }
+        ok = false;
+    }
+
+    std::string newLabel() {
+        return ".L" + std::to_string(labelCount++);
+    }
+
+    // MiniJava names cannot contain dots, so method labels (four parts) and
+    // vtable labels (three parts) never collide, whatever the program names
+    static std::string methodLabel(const std::string& className, const std::string& methodName) {
+        return "mj.m." + className + "." + methodName;
+    }
+
+    static std::string vtableLabel(const std::string& className) {
+        return "mj.vt." + className;
+    }
+
+    static int slotOffset(int slot) {
+        return -8 * (slot + 1);
+    }
+
+    // ---- Methods ----
+
+    bool enterFrame(Node* declaration) {
+        frame = symbolTable.getFrame(declaration);
+        if (!frame) fail(declaration, "no frame layout for '" + declaration->value + "'");
+        return frame != nullptr;
+    }
+
+    // Slot of a frame variable, in its register or in memory
+    std::string slotAddress(int slot) {
+        if (slotRegisters[slot] >= 0) return SAVED_REGISTERS[slotRegisters[slot]];
+        return std::to_string(slotOffset(slot)) + "(%rbp)";
+    }
+
+    void prologue(const std::string& label, Node* declaration, int slots) {
+        allocateRegisters(declaration, slots);
+        int saved = savedRegisters.size();
+        int frameBytes = (8 * (slots + saved) + 15) & ~15;
+        text << "\n\t.globl " << label << "\n\t.type " << label << ", @function\n" << label << ":\n";
+        text << "\tpushq %rbp\n\tmovq %rsp, %rbp\n";
+        if (frameBytes) text << "\tsubq $" << frameBytes << ", %rsp\n";
+        for (int i = 0; i < saved; ++i) {
+            text << "\tmovq " << SAVED_REGISTERS[savedRegisters[i]] << ", " << slotOffset(slots + i) << "(%rbp)\n";
+        }
+        // Start every slot at zero so locals read before assignment behave deterministically
+        for (int slot = 0; slot < slots; ++slot) {
+            text << "\tmovq $0, " << slotAddress(slot) << "\n";
+        }
+        pushDepth = 0;
+        boundsLabel = newLabel();
+        nullLabel = newLabel();
+    }
+
+    void epilogue() {
+        int slots = slotRegisters.size();
+        for (size_t i = 0; i < savedRegisters.size(); ++i) {
+            text << "\tmovq " << slotOffset(slots + i) << "(%rbp), " << SAVED_REGISTERS[savedRegisters[i]] << "\n";
+        }
+        text << "\tleave\n\tret\n";
+        // Shared out-of-line targets for failed array bounds and null checks
+        text << boundsLabel << ":\n\tandq $-16, %rsp\n\tcall mj_array_bounds\n";
+        text << nullLabel << ":\n\tandq $-16, %rsp\n\tcall mj_null_pointer\n";
+    }
+
+    // ---- Register allocation ----
+
+    // Linear scan over the live interval of every slot. Intervals are taken
+    // over the method in evaluation order and stretched over any loop they
+    // touch, so a register is never reused while its old value can still be read.
+    // When the registers run out, the interval with the fewest weighted uses stays in memory.
+    void allocateRegisters(Node* declaration, int slots) {
+        std::vector<LiveInterval> intervals(slots, LiveInterval{0, -1, -1, 0});
+        std::vector<std::pair<int, int>> loops;
+        int position = 0;
+        for (int slot = 0; slot < slots; ++slot) {
+            intervals[slot].slot = slot;
+        }
+        // 'this' and the parameters hold a value from the start
+        Node* params = findChild(declaration, "ParameterList");
+        if (declaration->type == "MethodDeclaration") touch(intervals, 0, 0, true, 0);
+        if (params) {
+            for (auto param : params->children) {
+                touch(intervals, frame->findSlot(param->value), 0, true, 0);
+            }
+        }
+        for (auto child : declaration->children) {
+            if (child->type == "StatementList" || child->type == "Return" || declaration->type == "MainMethod") {
+                collectUses(child, 0, 0, position, intervals, loops);
+            }
+        }
+
+        // Loops are nested or disjoint, repeat until the outermost ones are applied
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (const auto& loop : loops) {
+                for (auto& interval : intervals) {
+                    if (interval.start < 0 || interval.start > loop.second || interval.end < loop.first) continue;
+                    if (interval.start > loop.first || interval.end < loop.second) {
+                        interval.start = std::min(interval.start, loop.first);
+                        interval.end = std::max(interval.end, loop.second);
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        std::vector<LiveInterval> sorted;
+        for (const auto& interval : intervals) {
+            if (interval.start >= 0) sorted.push_back(interval);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const LiveInterval& a, const LiveInterval& b) {
+            return a.start < b.start;
+        });
+
+        slotRegisters.assign(slots, -1);
+        std::vector<LiveInterval> active;
+        std::vector<bool> used(SAVED_REGISTER_COUNT, false);
+        std::vector<bool> busy(SAVED_REGISTER_COUNT, false);
+        for (const auto& interval : sorted) {
+            // Free the registers of intervals that ended before this one starts
+            for (auto it = active.begin(); it != active.end();) {
+                if (it->end < interval.start) {
+                    busy[slotRegisters[it->slot]] = false;
+                    it = active.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            int reg = std::find(busy.begin(), busy.end(), false) - busy.begin();
+            if (reg == SAVED_REGISTER_COUNT) {
+                // All taken: the cheapest of the active intervals and this one goes to memory
+                auto cheapest = std::min_element(active.begin(), active.end(), [](const LiveInterval& a, const LiveInterval& b) {
+                    return a.weight < b.weight;
+                });
+                if (cheapest->weight >= interval.weight) continue;
+                reg = slotRegisters[cheapest->slot];
+                slotRegisters[cheapest->slot] = -1;
+                active.erase(cheapest);
+            }
+            slotRegisters[interval.slot] = reg;
+            busy[reg] = used[reg] = true;
+            active.push_back(interval);
+        }
+
+        savedRegisters.clear();
+        for (int reg = 0; reg < SAVED_REGISTER_COUNT; ++reg) {
+            if (used[reg]) savedRegisters.push_back(reg);
+        }
+    }
+
+    // Extends a slot's interval to 'position'. A local first met as the target
+    // of an assignment that always runs starts there, otherwise it starts at
+    // the beginning of the method, where it is zeroed.
+    void touch(std::vector<LiveInterval>& intervals, int slot, int position, bool defines, int loopDepth) {
+        LiveInterval& interval = intervals[slot];
+        if (interval.start < 0) interval.start = defines ? position : 0;
+        interval.end = std::max(interval.end, position);
+        double weight = 1;
+        for (int i = 0; i < loopDepth && i < 8; ++i) weight *= 10;
+        interval.weight += weight;
+    }
+
+    // 'nesting' counts the enclosing ifs and loops, 'loopDepth' only the loops
+    void collectUses(Node* node, int nesting, int loopDepth, int& position, std::vector<LiveInterval>& intervals,
+                     std::vector<std::pair<int, int>>& loops) {
+        const std::string& type = node->type;
+        if (type == "WhileStatement") {
+            int start = position++;
+            for (auto child : node->children) {
+                collectUses(child, nesting + 1, loopDepth + 1, position, intervals, loops);
+            }
+            loops.emplace_back(start, position++);
+            return;
+        }
+        if (type == "IfStatement") nesting++;
+
+        if (type == "ArrayAssignStatement") {
+            useVariable(node->value, false, nesting, loopDepth, position++, intervals);
+        }
+        for (auto child : node->children) {
+            collectUses(child, nesting, loopDepth, position, intervals, loops);
+        }
+        if (type == "Identifier") {
+            useVariable(node->value, false, nesting, loopDepth, position++, intervals);
+        } else if (type == "AssignStatement") {
+            useVariable(node->value, true, nesting, loopDepth, position++, intervals);
+        } else if (type == "This") {
+            touch(intervals, 0, position++, false, loopDepth);
+        }
+    }
+
+    void useVariable(const std::string& name, bool assigned, int nesting, int loopDepth, int position,
+                     std::vector<LiveInterval>& intervals) {
+        int slot = frame->findSlot(name);
+        if (slot > 0) {
+            touch(intervals, slot, position, assigned && nesting == 0, loopDepth);
+        } else {
+            // A field, reached through 'this'
+            touch(intervals, 0, position, false, loopDepth);
+        }
+    }
+
+    void generateMain(Node* mainClass) {
+        currentClass = "";
+        Node* mainMethod = findChild(mainClass, "MainMethod");
+        if (!mainMethod || !enterFrame(mainMethod)) return;
+
+        // Slot 0 would be 'this', unused in main
+        prologue("mj_main", mainMethod, frame->size);
+        for (auto child : mainMethod->children) {
+            generateStatement(child);
+        }
+        text << "\txorl %eax, %eax\n";
+        epilogue();
+    }
+
+    void generateMethod(Node* method) {
+        if (!enterFrame(method)) return;
+
+        prologue(methodLabel(currentClass, method->value), method, frame->size);
+
+        // Move 'this' and the parameters into their frame slots
+        text << "\tmovq %rdi, " << slotAddress(0) << "\n";
+        Node* params = findChild(method, "ParameterList");
+        if (params) {
+            int index = 1;
+            for (auto param : params->children) {
+                std::string address = slotAddress(frame->findSlot(param->value));
+                if (index < ARG_REGISTER_COUNT) {
+                    text << "\tmovq " << ARG_REGISTERS[index] << ", " << address << "\n";
+                } else {
+                    text << "\tmovq " << 16 + 8 * (index - ARG_REGISTER_COUNT) << "(%rbp), %rax\n";
+                    text << "\tmovq %rax, " << address << "\n";
+                }
+                index++;
+            }
+        }
+
+        for (auto child : method->children) {
+            if (child->type == "StatementList") {
+                generateStatement(child);
+            }
+        }
+
+        Node* returnNode = findChild(method, "Return");
+        if (returnNode && !returnNode->children.empty()) {
+            generateExpression(returnNode->children.front());
+        } else {
+            text << "\txorl %eax, %eax\n";
+        }
+        epilogue();
+    }
+
+    // ---- Variables ----
+
+    // Address of a named variable: a frame slot or a field of 'this'
+    bool variableAddress(Node* node, const std::string& name, std::string& address, std::string& type) {
+        int slot = frame->findSlot(name);
+        if (slot > 0) {
+            address = slotAddress(slot);
+            type = frame->variables[slot - 1]->type;
+            return true;
+        }
+
+        int field = currentClass.empty() ? -1 : classes[currentClass].findField(name, type);
+        if (field < 0) {
+            fail(node, "undeclared variable '" + name + "'");
+            return false;
+        }
+        std::string self = slotAddress(0);
+        if (slotRegisters[0] < 0) {
+            text << "\tmovq " << self << ", %r11\n";
+            self = "%r11";
+        }
+        address = std::to_string(8 * (field + 1)) + "(" + self + ")";
+        return true;
+    }
+
+    // ---- Statements ----
+
+    void generateStatement(Node* node) {
+        if (!ok) return;
+
+        if (node->type == "StatementList") {
+            for (auto child : node->children) {
+                generateStatement(child);
+            }
+        } else if (node->type == "VarDeclaration" || node->type == "ArrayDeclaration") {
+            // Slots are assigned up front
+        } else if (node->type == "IfStatement") {
+            auto it = node->children.begin();
+            std::string elseLabel = newLabel(), endLabel = newLabel();
+            generateExpression(*it++);
+            text << "\ttestq %rax, %rax\n\tje " << elseLabel << "\n";
+            generateStatement(*it++);
+            text << "\tjmp " << endLabel << "\n" << elseLabel << ":\n";
+            if (it != node->children.end()) generateStatement(*it);
+            text << endLabel << ":\n";
+        } else if (node->type == "WhileStatement") {
+            std::string conditionLabel = newLabel(), endLabel = newLabel();
+            text << conditionLabel << ":\n";
+            generateExpression(node->children.front());
+            text << "\ttestq %rax, %rax\n\tje " << endLabel << "\n";
+            generateStatement(node->children.back());
+            text << "\tjmp " << conditionLabel << "\n" << endLabel << ":\n";
+        } else if (node->type == "PrintStatement") {
+            generateExpression(node->children.front());
+            text << "\tmovq %rax, %rdi\n";
+            callRuntime("mj_println");
+        } else if (node->type == "AssignStatement") {
+            generateExpression(node->children.front());
+            std::string address, type;
+            if (variableAddress(node, node->value, address, type)) {
+                text << "\tmovq %rax, " << address << "\n";
+            }
+        } else if (node->type == "ArrayAssignStatement") {
+            std::string address, type;
+            if (!variableAddress(node, node->value, address, type)) return;
+            text << "\tmovq " << address << ", %rax\n";
+            push();
+            generateExpression(node->children.front());
+            push();
+            generateExpression(node->children.back());
+            pop("%rcx");
+            pop("%rdx");
+            boundsCheck();
+            text << "\tmovq %rax, 8(%rdx,%rcx,8)\n";
+        } else {
+            fail(node, "unsupported statement '" + node->type + "'");
+        }
+    }
+
+    // ---- Expressions, result in %rax ----
+
+    void push() {
+        text << "\tpushq %rax\n";
+        pushDepth++;
+    }
+
+    void pop(const char* reg) {
+        text << "\tpopq " << reg << "\n";
+        pushDepth--;
+    }
+
+    void callRuntime(const char* function) {
+        bool pad = pushDepth % 2 != 0;
+        if (pad) text << "\tsubq $8, %rsp\n";
+        text << "\tcall " << function << "\n";
+        if (pad) text << "\taddq $8, %rsp\n";
+    }
+
+    // Array in %rdx, index in %rcx
+    void boundsCheck() {
+        nullCheck("%rdx");
+        text << "\tcmpq (%rdx), %rcx\n\tjae " << boundsLabel << "\n";
+    }
+
+    void nullCheck(const char* reg) {
+        text << "\ttestq " << reg << ", " << reg << "\n\tje " << nullLabel << "\n";
+    }
+
+    // Operand for an expression that can be read in a single instruction
+    bool directOperand(Node* node, std::string& operand) {
+        if (node->type == "Int") {
+            int64_t value;
+            if (!parseIntLiteral(node->value, value)) return false;
+            operand = "$" + node->value;
+            return true;
+        }
+        if (node->type == "Identifier") {
+            int slot = frame->findSlot(node->value);
+            if (slot <= 0) return false;
+            operand = slotAddress(slot);
+            return true;
+        }
+        return false;
+    }
+
+    std::string generateExpression(Node* node) {
+        if (!ok) return "error";
+
+        const std::string& type = node->type;
+        if (type == "Int") {
+            int64_t value;
+            if (!parseIntLiteral(node->value, value)) {
+                fail(node, "integer literal " + node->value + " is too large");
+                return "error";
+            }
+            text << "\tmovq $" << value << ", %rax\n";
+            return "int";
+        }
+        if (type == "Boolean") {
+            text << "\tmovq $" << (node->value == "true" ? 1 : 0) << ", %rax\n";
+            return "boolean";
+        }
+        if (type == "Identifier") {
+            std::string address, varType;
+            if (!variableAddress(node, node->value, address, varType)) return "error";
+            text << "\tmovq " << address << ", %rax\n";
+            return varType;
+        }
+        if (type == "This") {
+            text << "\tmovq " << slotAddress(0) << ", %rax\n";
+            return currentClass;
+        }
+        if (type == "NewObject") {
+            auto layout = classes.find(node->value);
+            if (layout == classes.end()) {
+                fail(node, "undefined class '" + node->value + "'");
+                return "error";
+            }
+            text << "\tmovq $" << 8 * (layout->second.fields.size() + 1) << ", %rdi\n";
+            text << "\tleaq " << vtableLabel(node->value) << "(%rip), %rsi\n";
+            callRuntime("mj_new_object");
+            return node->value;
+        }
+        if (type == "NewArray") {
+            generateExpression(node->children.front());
+            text << "\tmovq %rax, %rdi\n";
+            callRuntime("mj_new_array");
+            return "int[]";
+        }
+        if (type == "ArrayAccess") {
+            std::string array;
+            if (directOperand(node->children.front(), array)) {
+                // Only a call could change a local, and calls cannot reach the caller's locals
+                generateExpression(node->children.back());
+                text << "\tmovq %rax, %rcx\n\tmovq " << array << ", %rdx\n";
+            } else {
+                generateExpression(node->children.front());
+                push();
+                generateExpression(node->children.back());
+                text << "\tmovq %rax, %rcx\n";
+                pop("%rdx");
+            }
+            boundsCheck();
+            text << "\tmovq 8(%rdx,%rcx,8), %rax\n";
+            return "int";
+        }
+        if (type == "Length") {
+            generateExpression(node->children.front());
+            nullCheck("%rax");
+            text << "\tmovq (%rax), %rax\n";
+            return "int";
+        }
+        if (type == "NotExpression") {
+            generateExpression(node->children.front());
+            text << "\txorq $1, %rax\n";
+            return "boolean";
+        }
+        if (type == "AndExpression" || type == "OrExpression") {
+            // Short-circuit: the right operand only runs if the left does not decide the result
+            std::string endLabel = newLabel();
+            generateExpression(node->children.front());
+            text << "\ttestq %rax, %rax\n\t" << (type == "AndExpression" ? "je " : "jne ") << endLabel << "\n";
+            generateExpression(node->children.back());
+            text << endLabel << ":\n";
+            return "boolean";
+        }
+        if (type == "AddExpression" || type == "SubExpression" || type == "MultExpression" ||
+            type == "LessThanExpression" || type == "EqualExpression") {
+            std::string operand;
+            generateExpression(node->children.front());
+            if (directOperand(node->children.back(), operand)) {
+                // A constant or a variable in a register or frame slot needs no temporary
+                text << "\tmovq " << operand << ", %rcx\n";
+            } else {
+                push();
+                generateExpression(node->children.back());
+                text << "\tmovq %rax, %rcx\n";
+                pop("%rax");
+            }
+
+            if (type == "LessThanExpression" || type == "EqualExpression") {
+                text << "\tcmpq %rcx, %rax\n\t" << (type == "LessThanExpression" ? "setl" : "sete") << " %al\n";
+                text << "\tmovzbq %al, %rax\n";
+                return "boolean";
+            }
+
+            // Java ints are 32 bits and wrap around, keep them sign-extended in 64-bit registers
+            const char* op = type == "AddExpression" ? "addl" : type == "SubExpression" ? "subl" : "imull";
+            text << "\t" << op << " %ecx, %eax\n\tmovslq %eax, %rax\n";
+            return "int";
+        }
+        if (type == "MethodCall") {
+            return generateCall(node);
+        }
+        if (type == "FieldRead") {
+            // A field of another object, left by the inliner, at its offset in the class that declares the getter
+            std::string fieldType;
+            auto owner = classes.find(node->children.back()->value);
+            int field = owner == classes.end() ? -1 : owner->second.findField(node->value, fieldType);
+            if (field < 0) {
+                fail(node, "undeclared field '" + node->value + "'");
+                return "error";
+            }
+            generateExpression(node->children.front());
+            nullCheck("%rax");
+            text << "\tmovq " << 8 * (field + 1) << "(%rax), %rax\n";
+            return fieldType;
+        }
+
+        fail(node, "unsupported expression '" + type + "'");
+        return "error";
+    }
+
+    std::string generateCall(Node* node) {
+        std::vector<Node*> arguments;
+        Node* argList = node->children.size() > 1 ? node->children.back() : nullptr;
+        if (argList) {
+            arguments.assign(argList->children.begin(), argList->children.end());
+        }
+
+        // Evaluate the receiver and the arguments left to right onto the stack
+        std::string receiverType = generateExpression(node->children.front());
+        push();
+        for (auto argument : arguments) {
+            generateExpression(argument);
+            push();
+        }
+        if (!ok) return "error";
+
+        int index;
+        auto layout = classes.find(receiverType);
+        const MethodInfo* method = layout == classes.end() ? nullptr : layout->second.findMethod(node->value, index);
+        if (!method) {
+            fail(node, "undefined method '" + node->value + "' in class '" + receiverType + "'");
+            return "error";
+        }
+
+        int count = arguments.size() + 1;
+        int stackArgs = count > ARG_REGISTER_COUNT ? count - ARG_REGISTER_COUNT : 0;
+        bool pad = (pushDepth + stackArgs) % 2 != 0;
+        if (pad) text << "\tsubq $8, %rsp\n";
+
+        // Copy arguments past the sixth into place, last one pushed first
+        int extra = pad ? 1 : 0;
+        for (int i = count - 1; i >= ARG_REGISTER_COUNT; --i) {
+            text << "\tpushq " << 8 * (count - 1 - i + extra) << "(%rsp)\n";
+            extra++;
+        }
+        for (int i = 0; i < count && i < ARG_REGISTER_COUNT; ++i) {
+            text << "\tmovq " << 8 * (count - 1 - i + extra) << "(%rsp), " << ARG_REGISTERS[i] << "\n";
+        }
+
+        // Dynamic dispatch through the receiver's vtable
+        nullCheck("%rdi");
+        text << "\tmovq (%rdi), %rax\n\tcall *" << 8 * index << "(%rax)\n";
+        text << "\taddq $" << 8 * (count + extra) << ", %rsp\n";
+        pushDepth -= count;
+        return method->returnType;
+    }
+};
+
+} // namespace
+
+bool generateAssembly(Node* root, const SymbolTable& symbolTable, const std::string& filename) {
+    CodeGenerator generator(symbolTable);
+    std::ostringstream assembly;
+    if (!root || !generator.generate(root, assembly)) return false;
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+    out << assembly.str();
+    std::cout << "Generated assembly file: " << filename << ". Use 'make native' to build the executable.\n";
+    return true;
+}
@@ -0,0 +1,14 @@
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include <string>
+#include "Node.h"
+#include "symboltable.h"
+
+// Lowers a type-checked AST to x86-64 assembly (GNU as, System V ABI).
+// The output links against runtime.c, see 'make native'. Returns false if a
+// construct could not be lowered, with the reason printed to std::cerr.
+// Frame slots come from the layout buildSymbolTable assigned to each method.
+bool generateAssembly(Node* root, const SymbolTable& symbolTable, const std::string& filename);
+
+#endif // CODEGEN_H
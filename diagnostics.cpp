@@ -0,0 +1,125 @@
+#include "diagnostics.h"
+#include <algorithm>
+#include <sstream>
+#include <cctype>
+
+Diagnostics::Diagnostics() : errorCount(0), maxErrors(0), limitHit(false) {}
+
+void Diagnostics::setMaxErrors(int limit) {
+    maxErrors = limit > 0 ? limit : 0;
+}
+
+void Diagnostics::report(Severity severity, int line, const std::string& code, const std::string& message) {
+    if (limitHit) return;
+    
+    // Drop exact duplicates, e.g. an expression checked both on its own and as an operand
+    std::string key = code + '\n' + message;
+    if (!seen.insert(std::to_string(line) + '\n' + key).second) return;
+    
+    // Folded repeats still count toward the error total and the limit
+    if (severity == Severity::Error) {
+        errorCount++;
+        if (maxErrors && errorCount >= maxErrors) {
+            limitHit = true;
+        }
+    }
+    
+    // Fold a message that keeps repeating on new lines into the last listed occurrence
+    auto it = repeats.find(key);
+    if (it != repeats.end() && it->second.first >= DIAGNOSTIC_REPEAT_LIMIT) {
+        diagnostics[it->second.second].repeats++;
+        return;
+    }
+    
+    auto& entry = repeats[key];
+    entry.first++;
+    entry.second = diagnostics.size();
+    diagnostics.push_back({severity, line, code, message, 0});
+}
+
+void Diagnostics::error(int line, const std::string& code, const std::string& message) {
+    report(Severity::Error, line, code, message);
+}
+
+void Diagnostics::warning(int line, const std::string& code, const std::string& message) {
+    report(Severity::Warning, line, code, message);
+}
+
+bool Diagnostics::hasErrors() const {
+    return errorCount > 0;
+}
+
+int Diagnostics::getErrorCount() const {
+    return errorCount;
+}
+
+bool Diagnostics::limitReached() const {
+    return limitHit;
+}
+
+namespace {
+
+std::vector<const Diagnostic*> sortedByLine(const std::vector<Diagnostic>& diagnostics) {
+    std::vector<const Diagnostic*> sorted;
+    for (const auto& diagnostic : diagnostics) {
+        sorted.push_back(&diagnostic);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Diagnostic* a, const Diagnostic* b) {
+        return a->line < b->line;
+    });
+    return sorted;
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+void Diagnostics::print(std::ostream& out, const std::string& phase) const {
+    if (diagnostics.empty()) return;
+    
+    // Build the whole report first so it is written in one go
+    std::ostringstream buffer;
+    buffer << phase << " errors found! See the logs below:\n";
+    for (const Diagnostic* diagnostic : sortedByLine(diagnostics)) {
+        buffer << "\t@" << (diagnostic->severity == Severity::Error ? "error" : "warning")
+               << " at line " << diagnostic->line << ". " << diagnostic->message;
+        if (diagnostic->repeats) {
+            buffer << " (repeated on " << diagnostic->repeats << " more line(s))";
+        }
+        buffer << "\n";
+    }
+    if (limitHit) {
+        buffer << "Too many errors, analysis stopped after " << errorCount << ".\n";
+    }
+    std::string lowerPhase = phase;
+    if (!lowerPhase.empty()) lowerPhase[0] = std::tolower(lowerPhase[0]);
+    buffer << "End of " << lowerPhase << " errors!\n";
+    
+    out << buffer.str();
+}
+
+void Diagnostics::printJson(std::ostream& out) const {
+    std::ostringstream buffer;
+    buffer << "{\n  \"errorCount\": " << errorCount << ",\n  \"limitReached\": " << (limitHit ? "true" : "false")
+           << ",\n  \"diagnostics\": [";
+    
+    bool first = true;
+    for (const Diagnostic* diagnostic : sortedByLine(diagnostics)) {
+        buffer << (first ? "\n" : ",\n") << "    {\"severity\": \""
+               << (diagnostic->severity == Severity::Error ? "error" : "warning")
+               << "\", \"line\": " << diagnostic->line << ", \"code\": \"" << diagnostic->code
+               << "\", \"message\": \"" << escapeJson(diagnostic->message) << "\", \"repeats\": "
+               << diagnostic->repeats << "}";
+        first = false;
+    }
+    buffer << "\n  ]\n}\n";
+    
+    out << buffer.str();
+}
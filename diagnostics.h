@@ -0,0 +1,57 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+// Severity of a diagnostic
+enum class Severity {
+    Warning,
+    Error
+};
+
+// A single compiler message. 'code' is a stable identifier such as "undeclared-identifier".
+struct Diagnostic {
+    Severity severity;
+    int line;
+    std::string code;
+    std::string message;
+    int repeats; // Occurrences of the same code and message folded into this one
+};
+
+// Lines on which the same code and message is listed before further repeats are folded
+const int DIAGNOSTIC_REPEAT_LIMIT = 10;
+
+// Collects diagnostics during analysis and prints them in one buffered, line-sorted batch.
+// Identical messages on one line are reported once, a message repeated on many lines is
+// folded after DIAGNOSTIC_REPEAT_LIMIT lines, and collection stops after maxErrors errors.
+class Diagnostics {
+private:
+    std::vector<Diagnostic> diagnostics;
+    std::set<std::string> seen; // line + code + message
+    std::unordered_map<std::string, std::pair<int, size_t>> repeats; // code + message -> (lines listed, last index)
+    int errorCount;
+    int maxErrors; // 0 means no limit
+    bool limitHit;
+    
+public:
+    Diagnostics();
+    
+    void setMaxErrors(int limit);
+    void report(Severity severity, int line, const std::string& code, const std::string& message);
+    void error(int line, const std::string& code, const std::string& message);
+    void warning(int line, const std::string& code, const std::string& message);
+    
+    bool hasErrors() const;
+    int getErrorCount() const;
+    bool limitReached() const;
+    
+    // Writes the collected diagnostics, in the "@error at line N." format or as JSON
+    void print(std::ostream& out, const std::string& phase) const;
+    void printJson(std::ostream& out) const;
+};
+
+#endif // DIAGNOSTICS_H
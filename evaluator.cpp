@@ -0,0 +1,779 @@
+#include "evaluator.h"
+#include "classlayout.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Deepest MiniJava call chain before evaluation stops with a stack overflow.
+// Calls do not nest in C++, each one only costs a few hundred bytes of heap.
+const int MAX_CALL_DEPTH = 2000000;
+// Size of a semispace until the live data outgrows it
+const size_t INITIAL_HEAP_SIZE = 1024 * 1024;
+
+struct Cell;
+
+// MiniJava values: int and boolean in 'number', otherwise an object or an int array
+struct Value {
+    int64_t number = 0;
+    Cell* reference = nullptr;
+};
+
+// Header of an object or int array in the managed heap. An object's fields
+// (Values) or an array's elements follow it in the same block.
+struct Cell {
+    // Length of a cell the collector has already copied, 'forward' then holds the copy
+    static const int64_t FORWARDED = -1;
+
+    union {
+        const ClassLayout* layout; // Class of an object, null for an int array
+        Cell* forward;
+    };
+    int64_t length; // Number of fields or elements
+
+    Value* fields() { return reinterpret_cast<Value*>(this + 1); }
+    int64_t* elements() { return reinterpret_cast<int64_t*>(this + 1); }
+
+    static size_t sizeFor(const ClassLayout* layout, int64_t length) {
+        return sizeof(Cell) + length * (layout ? sizeof(Value) : sizeof(int64_t));
+    }
+};
+
+// Stops evaluation, like an uncaught Java exception
+struct RuntimeError {
+    int line;
+    std::string message;
+};
+
+// Activation of a method: a window of the value stack laid out by the symbol
+// table, 'this' in slot 0 followed by the parameters and locals
+struct Frame {
+    const FrameLayout* layout;
+    size_t base;
+};
+
+// Semispace heap. Cells are bump-allocated in the current space; when it is
+// full the collector copies the live ones into a new space (Cheney's
+// algorithm) and frees the old one whole, so garbage costs nothing to free.
+// The caller hands every root to forward() between the two collection calls.
+class Heap {
+public:
+    Heap() : capacity(INITIAL_HEAP_SIZE), space(new char[INITIAL_HEAP_SIZE]), top(space.get()) {}
+
+    // Room for 'bytes' in the current space, nullptr once it is full
+    Cell* allocate(size_t bytes) {
+        if (bytes > capacity - used()) return nullptr;
+        Cell* cell = reinterpret_cast<Cell*>(top);
+        top += bytes;
+        return cell;
+    }
+
+    // Starts a collection into a space with room for everything in the
+    // current one plus 'needed' bytes. Returns false, with the heap untouched,
+    // if that space cannot be allocated.
+    bool beginCollection(size_t needed) {
+        // Grow when the last collection left the space more than half full
+        size_t size = capacity;
+        if (2 * lastLive > capacity) size *= 2;
+        while (size - used() < needed) size *= 2;
+
+        nextSpace.reset(new (std::nothrow) char[size]);
+        if (!nextSpace) return false;
+        nextCapacity = size;
+        scan = nextTop = nextSpace.get();
+        return true;
+    }
+
+    // Updates a root to the new address of the cell it refers to
+    void forward(Value& value) {
+        if (value.reference) value.reference = copy(value.reference);
+    }
+
+    // Copies what the copied cells refer to, then switches to the new space.
+    // Returns the number of bytes that survived.
+    size_t finishCollection() {
+        while (scan < nextTop) {
+            Cell* cell = reinterpret_cast<Cell*>(scan);
+            if (cell->layout) {
+                // Only fields declared with a class or array type can refer to a cell
+                Value* fields = cell->fields();
+                const std::vector<bool>& references = cell->layout->references;
+                for (size_t i = 0; i < references.size(); ++i) {
+                    if (references[i]) forward(fields[i]);
+                }
+            }
+            scan += Cell::sizeFor(cell->layout, cell->length);
+        }
+
+        space = std::move(nextSpace);
+        capacity = nextCapacity;
+        top = nextTop;
+        lastLive = used();
+        return lastLive;
+    }
+
+    size_t size() const { return capacity; }
+
+private:
+    size_t capacity;
+    std::unique_ptr<char[]> space;
+    char* top;
+    size_t lastLive = 0;
+
+    // Space being filled by a collection
+    size_t nextCapacity = 0;
+    std::unique_ptr<char[]> nextSpace;
+    char* nextTop = nullptr;
+    char* scan = nullptr;
+
+    size_t used() const {
+        return top - space.get();
+    }
+
+    Cell* copy(Cell* cell) {
+        if (cell->length == Cell::FORWARDED) return cell->forward;
+        size_t bytes = Cell::sizeFor(cell->layout, cell->length);
+        Cell* moved = reinterpret_cast<Cell*>(nextTop);
+        std::memcpy(moved, cell, bytes);
+        nextTop += bytes;
+        cell->forward = moved;
+        cell->length = Cell::FORWARDED;
+        return moved;
+    }
+};
+
+// Kinds of resolved nodes, one per AST node type the evaluator runs
+enum class Op {
+    Int, Boolean, Variable, This, NewObject, NewArray, ArrayAccess, Length, Not, And, Or,
+    Equal, Add, Sub, Mult, LessThan, Call, FieldRead,
+    Sequence, Nothing, If, While, Print, Assign, ArrayAssign, Body, Unsupported
+};
+
+struct MethodCode;
+
+// An AST node with its names resolved, built once per method before its first
+// call. Evaluation walks these instead of comparing node type strings.
+struct Code {
+    Op op;
+    Node* node;                  // Line numbers and names for error messages
+    std::vector<Code*> children;
+    int64_t number = 0;          // Int and Boolean
+    int slot = -1;               // Variable, Assign, ArrayAssign: frame slot, or -1 for a field
+    int field = -1;              // Index of that field, or of the field a FieldRead reads
+    bool reference = false;      // The slot or field is declared with a class or array type
+    const ClassLayout* layout = nullptr; // NewObject: the class to create
+
+    // Call: last receiver class seen and the method it dispatched to
+    const ClassLayout* cachedClass = nullptr;
+    MethodCode* cachedMethod = nullptr;
+};
+
+// A method ready to be called: its frame and its body
+struct MethodCode {
+    const FrameLayout* layout;
+    Node* params;   // ParameterList, or null
+    Code* body;     // Body: the statement lists, then the returned expression
+};
+
+// Pending work on a node. 'step' is how far its evaluation got, 'base' is the
+// value stack height it started from (the callee's frame for a Call).
+struct Task {
+    Code* code;
+    int step;
+    size_t base;
+};
+
+// Evaluates the tree without recursing in C++: pending nodes wait on an
+// explicit task stack and intermediate results on the value stack, so the
+// depth of MiniJava recursion is bounded by memory, not by the thread's stack.
+class Evaluator {
+public:
+    Evaluator(const SymbolTable& symbolTable, HeapStats& stats) : symbolTable(symbolTable), stats(stats) {}
+
+    bool run(Node* root) {
+        std::string error;
+        int errorLine = 0;
+        if (!buildClassLayouts(root, classes, error, errorLine)) {
+            std::cerr << "Evaluation error at line " << errorLine << ": " << error << std::endl;
+            return false;
+        }
+
+        Node* mainClass = findChild(root, "MainClass");
+        Node* mainMethod = mainClass ? findChild(mainClass, "MainMethod") : nullptr;
+        if (!mainMethod) return false;
+
+        bool success = true;
+        try {
+            MethodCode* main = methodCode(mainMethod, mainMethod, nullptr);
+            stack.resize(main->layout->size);
+            frames.push_back(Frame{main->layout, 0});
+            tasks.push_back(Task{main->body, 0, 0});
+            execute();
+        } catch (const RuntimeError& exception) {
+            std::cout.flush();
+            std::cerr << "Exception at line " << exception.line << ": " << exception.message << std::endl;
+            success = false;
+        }
+        std::cout.flush();
+        stats.heapSize = heap.size();
+        return success;
+    }
+
+private:
+    const SymbolTable& symbolTable;
+    HeapStats& stats;
+    ClassLayouts classes;
+    Heap heap;
+    std::vector<Value> stack;  // Frames of all active calls, innermost last, and operands being evaluated
+    std::vector<Frame> frames; // Where those frames are, for the collector
+    std::vector<Task> tasks;   // Nodes being evaluated, innermost last
+    int callDepth = 0;
+
+    // Resolved code, owned here
+    std::vector<std::unique_ptr<Code>> codes;
+    std::unordered_map<const Node*, std::unique_ptr<MethodCode>> methods;
+
+    // Java ints are 32 bits and wrap around
+    static int64_t wrap(int64_t value) {
+        return (int32_t)(uint32_t)value;
+    }
+
+    const FrameLayout& frameOf(Node* node, Node* declaration) {
+        const FrameLayout* layout = symbolTable.getFrame(declaration);
+        if (!layout) {
+            throw RuntimeError{node->lineno, "no frame layout for '" + declaration->value + "'"};
+        }
+        return *layout;
+    }
+
+    // ---- Resolution ----
+
+    // Resolves a method on its first call. 'owner' is the class declaring it,
+    // whose fields its names refer to (null for main).
+    MethodCode* methodCode(Node* node, Node* declaration, const ClassLayout* owner) {
+        std::unique_ptr<MethodCode>& method = methods[declaration];
+        if (method) return method.get();
+
+        const FrameLayout& layout = frameOf(node, declaration);
+        Code* body = newCode(Op::Body, declaration);
+        for (auto child : declaration->children) {
+            // main's statements are its direct children, a method's are in its statement list
+            if (child->type == "StatementList" || declaration->type == "MainMethod") {
+                body->children.push_back(resolve(child, layout, owner));
+            }
+        }
+        Node* returnNode = findChild(declaration, "Return");
+        if (returnNode && !returnNode->children.empty()) {
+            body->children.push_back(resolve(returnNode->children.front(), layout, owner));
+            body->number = 1; // The last child is the returned expression
+        }
+
+        method.reset(new MethodCode{&layout, findChild(declaration, "ParameterList"), body});
+        return method.get();
+    }
+
+    Code* newCode(Op op, Node* node) {
+        codes.emplace_back(new Code());
+        Code* code = codes.back().get();
+        code->op = op;
+        code->node = node;
+        return code;
+    }
+
+    static Op opOf(const std::string& type) {
+        static const std::unordered_map<std::string, Op> ops = {
+            {"Int", Op::Int}, {"Boolean", Op::Boolean}, {"Identifier", Op::Variable}, {"This", Op::This},
+            {"NewObject", Op::NewObject}, {"NewArray", Op::NewArray}, {"ArrayAccess", Op::ArrayAccess},
+            {"Length", Op::Length}, {"NotExpression", Op::Not}, {"AndExpression", Op::And},
+            {"OrExpression", Op::Or}, {"EqualExpression", Op::Equal}, {"AddExpression", Op::Add},
+            {"SubExpression", Op::Sub}, {"MultExpression", Op::Mult}, {"LessThanExpression", Op::LessThan},
+            {"MethodCall", Op::Call}, {"FieldRead", Op::FieldRead}, {"StatementList", Op::Sequence},
+            {"VarDeclaration", Op::Nothing}, {"ArrayDeclaration", Op::Nothing}, {"IfStatement", Op::If},
+            {"WhileStatement", Op::While}, {"PrintStatement", Op::Print}, {"AssignStatement", Op::Assign},
+            {"ArrayAssignStatement", Op::ArrayAssign},
+        };
+        auto it = ops.find(type);
+        return it == ops.end() ? Op::Unsupported : it->second;
+    }
+
+    // A name is a slot of the frame, else a field of the declaring class. An
+    // unknown name is left unresolved and only fails if it is evaluated.
+    void resolveVariable(Code* code, const std::string& name, const FrameLayout& layout, const ClassLayout* owner) {
+        code->slot = layout.findSlot(name);
+        if (code->slot > 0) {
+            code->reference = layout.references[code->slot];
+            return;
+        }
+        code->slot = -1;
+        std::string type;
+        code->field = owner ? owner->findField(name, type) : -1;
+        if (code->field >= 0) code->reference = owner->references[code->field];
+    }
+
+    Code* resolve(Node* node, const FrameLayout& layout, const ClassLayout* owner) {
+        Code* code = newCode(opOf(node->type), node);
+        switch (code->op) {
+        case Op::Int:
+            // Reported when the method is first called, before any of it runs
+            if (!parseIntLiteral(node->value, code->number)) {
+                throw RuntimeError{node->lineno, "integer literal " + node->value + " is too large"};
+            }
+            break;
+        case Op::Boolean:
+            code->number = node->value == "true";
+            break;
+        case Op::Variable:
+        case Op::Assign:
+        case Op::ArrayAssign:
+            resolveVariable(code, node->value, layout, owner);
+            break;
+        case Op::NewObject: {
+            auto it = classes.find(node->value);
+            code->layout = it == classes.end() ? nullptr : &it->second;
+            break;
+        }
+        case Op::FieldRead: {
+            // Laid out as in the class that declares the getter, which may hide a field of a subclass
+            auto it = classes.find(node->children.back()->value);
+            std::string type;
+            code->field = it == classes.end() ? -1 : it->second.findField(node->value, type);
+            code->children.push_back(resolve(node->children.front(), layout, owner));
+            return code;
+        }
+        case Op::Call:
+            // The receiver, then the arguments
+            code->children.push_back(resolve(node->children.front(), layout, owner));
+            if (node->children.size() > 1) {
+                for (auto argument : node->children.back()->children) {
+                    code->children.push_back(resolve(argument, layout, owner));
+                }
+            }
+            return code;
+        default:
+            break;
+        }
+        for (auto child : node->children) {
+            code->children.push_back(resolve(child, layout, owner));
+        }
+        return code;
+    }
+
+    // ---- Heap ----
+
+    // A zeroed object or array. This may collect, which moves cells: a
+    // reference stays valid only if it is kept on the value stack or in the heap.
+    Cell* allocate(Node* node, const ClassLayout* layout, int64_t length) {
+        size_t bytes = Cell::sizeFor(layout, length);
+        Cell* cell = heap.allocate(bytes);
+        if (!cell) {
+            collect(node, 0);
+            cell = heap.allocate(bytes);
+        }
+        if (!cell) {
+            // The survivors left too little room, move them into a space that fits
+            collect(node, bytes);
+            cell = heap.allocate(bytes);
+        }
+        cell->layout = layout;
+        cell->length = length;
+        std::memset(cell + 1, 0, bytes - sizeof(Cell));
+        stats.allocations++;
+        stats.bytesAllocated += bytes;
+        return cell;
+    }
+
+    void collect(Node* node, size_t needed) {
+        auto start = std::chrono::steady_clock::now();
+        if (!heap.beginCollection(needed)) {
+            throw RuntimeError{node->lineno, "out of memory"};
+        }
+
+        // Frame slots are scanned by their declared types. What lies between
+        // two frames (operands and arguments still being evaluated) has no
+        // declared type, so every reference there is a root.
+        size_t position = 0;
+        for (const Frame& frame : frames) {
+            for (; position < frame.base; ++position) {
+                heap.forward(stack[position]);
+            }
+            const std::vector<bool>& references = frame.layout->references;
+            for (size_t slot = 0; slot < references.size(); ++slot) {
+                if (references[slot]) heap.forward(stack[frame.base + slot]);
+            }
+            position = frame.base + references.size();
+        }
+        for (; position < stack.size(); ++position) {
+            heap.forward(stack[position]);
+        }
+        stats.liveBytes = heap.finishCollection();
+
+        std::chrono::duration<double, std::milli> pause = std::chrono::steady_clock::now() - start;
+        stats.collections++;
+        stats.totalPause += pause.count();
+        stats.longestPause = std::max(stats.longestPause, pause.count());
+    }
+
+    // ---- Variables ----
+
+    // The slot or field a resolved name refers to, valid until the next call or allocation
+    Value& variable(Code* code) {
+        const Frame& frame = frames.back();
+        if (code->slot > 0) return stack[frame.base + code->slot];
+
+        Cell* object = stack[frame.base].reference;
+        if (code->field < 0 || !object) {
+            throw RuntimeError{code->node->lineno, "undeclared variable '" + code->node->value + "'"};
+        }
+        return object->fields()[code->field];
+    }
+
+    // The collector only follows variables declared with a class or array type,
+    // so an ill-typed program must not hide a reference anywhere else
+    void checkStore(Node* node, const std::string& name, const Value& value, bool reference) {
+        if (value.reference && !reference) {
+            throw RuntimeError{node->lineno, "object or array stored in '" + name + "', which is not declared to hold one"};
+        }
+    }
+
+    Cell* arrayOf(Node* node, const Value& value) {
+        if (!value.reference || value.reference->layout) throw RuntimeError{node->lineno, "null array"};
+        return value.reference;
+    }
+
+    int64_t& element(Node* node, const Value& arrayValue, int64_t index) {
+        Cell* array = arrayOf(node, arrayValue);
+        if (index < 0 || index >= array->length) {
+            throw RuntimeError{node->lineno, "array index " + std::to_string(index) + " out of bounds"};
+        }
+        return array->elements()[index];
+    }
+
+    // ---- Evaluation ----
+
+    Value number(int64_t value) {
+        Value result;
+        result.number = value;
+        return result;
+    }
+
+    Value reference(Cell* cell) {
+        Value result;
+        result.reference = cell;
+        return result;
+    }
+
+    Value pop() {
+        Value value = stack.back();
+        stack.pop_back();
+        return value;
+    }
+
+    // Finishes the current task, an expression leaves its value on the stack
+    void done(const Value& value) {
+        tasks.pop_back();
+        stack.push_back(value);
+    }
+
+    // Runs the current task's next child, coming back at 'step'
+    void next(Code* child, int step) {
+        tasks.back().step = step;
+        tasks.push_back(Task{child, 0, stack.size()});
+    }
+
+    // Runs tasks until the stack of pending nodes is empty. Each pass looks at
+    // the innermost task: it either schedules one of its children and comes
+    // back to it later, or finishes with its children's results on the stack.
+    void execute() {
+        while (!tasks.empty()) {
+            Task& task = tasks.back();
+            Code* code = task.code;
+            Node* node = code->node;
+            switch (code->op) {
+            case Op::Int:
+            case Op::Boolean:
+                done(number(code->number));
+                break;
+            case Op::Variable:
+                done(variable(code));
+                break;
+            case Op::This:
+                done(stack[frames.back().base]);
+                break;
+            case Op::NewObject:
+                if (!code->layout) {
+                    throw RuntimeError{node->lineno, "undefined class '" + node->value + "'"};
+                }
+                done(reference(allocate(node, code->layout, code->layout->fields.size())));
+                break;
+            case Op::NewArray:
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else {
+                    int64_t length = pop().number;
+                    if (length < 0) {
+                        throw RuntimeError{node->lineno, "negative array size " + std::to_string(length)};
+                    }
+                    done(reference(allocate(node, nullptr, length)));
+                }
+                break;
+            case Op::ArrayAccess:
+            case Op::Equal:
+            case Op::Add:
+            case Op::Sub:
+            case Op::Mult:
+            case Op::LessThan:
+                // Both operands wait on the stack, where a collection can move a reference
+                if (task.step < 2) {
+                    next(task.step == 0 ? code->children.front() : code->children.back(), task.step + 1);
+                } else {
+                    Value right = pop();
+                    Value left = pop();
+                    done(binary(code, left, right));
+                }
+                break;
+            case Op::Length:
+            case Op::Not:
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else {
+                    Value operand = pop();
+                    done(code->op == Op::Not ? number(operand.number == 0) : number(arrayOf(node, operand)->length));
+                }
+                break;
+            case Op::And:
+            case Op::Or:
+                // Short-circuit: the right operand only runs if the left does not decide the result
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else if (task.step == 1) {
+                    bool left = pop().number != 0;
+                    if (left == (code->op == Op::Or)) {
+                        done(number(left));
+                    } else {
+                        next(code->children.back(), 2);
+                    }
+                } else {
+                    done(number(pop().number != 0));
+                }
+                break;
+            case Op::FieldRead:
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else {
+                    Cell* object = pop().reference;
+                    if (!object || !object->layout) {
+                        throw RuntimeError{node->lineno, "field '" + node->value + "' read on null"};
+                    }
+                    if (code->field < 0) {
+                        throw RuntimeError{node->lineno, "undeclared field '" + node->value + "'"};
+                    }
+                    done(object->fields()[code->field]);
+                }
+                break;
+            case Op::Call:
+                call(task);
+                break;
+            case Op::Body:
+                // Statements, then the returned expression, whose value is left as the result
+                if ((size_t)task.step < code->children.size()) {
+                    next(code->children[task.step], task.step + 1);
+                } else {
+                    if (!code->number) stack.push_back(Value());
+                    tasks.pop_back();
+                }
+                break;
+            case Op::Sequence:
+                if ((size_t)task.step < code->children.size()) {
+                    next(code->children[task.step], task.step + 1);
+                } else {
+                    tasks.pop_back();
+                }
+                break;
+            case Op::Nothing:
+                // Slots are assigned when the frame is created
+                tasks.pop_back();
+                break;
+            case Op::If:
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else if (task.step == 1) {
+                    bool condition = pop().number != 0;
+                    if (condition) {
+                        next(code->children[1], 2);
+                    } else if (code->children.size() > 2) {
+                        next(code->children[2], 2);
+                    } else {
+                        tasks.pop_back();
+                    }
+                } else {
+                    tasks.pop_back();
+                }
+                break;
+            case Op::While:
+                // Step 0 evaluates the condition, which the body goes back to
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else if (pop().number != 0) {
+                    next(code->children.back(), 0);
+                } else {
+                    tasks.pop_back();
+                }
+                break;
+            case Op::Print:
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else {
+                    std::cout << pop().number << '\n';
+                    tasks.pop_back();
+                }
+                break;
+            case Op::Assign:
+                if (task.step == 0) {
+                    next(code->children.front(), 1);
+                } else {
+                    Value value = pop();
+                    Value& target = variable(code);
+                    checkStore(node, node->value, value, code->reference);
+                    target = value;
+                    tasks.pop_back();
+                }
+                break;
+            case Op::ArrayAssign:
+                // The array waits on the stack, where a collection during the index or value can move it
+                if (task.step == 0) {
+                    stack.push_back(variable(code));
+                    next(code->children.front(), 1);
+                } else if (task.step == 1) {
+                    next(code->children.back(), 2);
+                } else {
+                    int64_t value = pop().number;
+                    int64_t index = pop().number;
+                    Value array = pop();
+                    element(node, array, index) = value;
+                    tasks.pop_back();
+                }
+                break;
+            case Op::Unsupported:
+                throw RuntimeError{node->lineno, "unsupported node '" + node->type + "'"};
+            }
+        }
+    }
+
+    Value binary(Code* code, const Value& left, const Value& right) {
+        switch (code->op) {
+        case Op::ArrayAccess:
+            return number(element(code->node, left, right.number));
+        case Op::Equal:
+            // References are compared too
+            return number(left.number == right.number && left.reference == right.reference);
+        case Op::Add:
+            return number(wrap(left.number + right.number));
+        case Op::Sub:
+            return number(wrap(left.number - right.number));
+        case Op::Mult:
+            return number(wrap(left.number * right.number));
+        default:
+            return number(left.number < right.number);
+        }
+    }
+
+    // The callee's frame starts where the receiver was pushed: the arguments are
+    // evaluated straight into the slots after it. Step k evaluates child k
+    // (receiver, then arguments), the next step enters the method and the
+    // last one, once its body has run, replaces the frame by the result.
+    void call(Task& task) {
+        Code* code = task.code;
+        Node* node = code->node;
+        size_t argCount = code->children.size() - 1;
+        if ((size_t)task.step <= argCount) {
+            next(code->children[task.step], task.step + 1);
+            return;
+        }
+
+        size_t base = task.base;
+        if ((size_t)task.step == argCount + 2) {
+            // The body has left the result on top of its frame
+            Value result = stack.back();
+            frames.pop_back();
+            callDepth--;
+            stack.resize(base);
+            done(result);
+            return;
+        }
+
+        Cell* receiver = stack[base].reference;
+        if (!receiver || !receiver->layout) {
+            throw RuntimeError{node->lineno, "method '" + node->value + "' called on null"};
+        }
+        if (callDepth >= MAX_CALL_DEPTH) {
+            throw RuntimeError{node->lineno, "stack overflow after " + std::to_string(callDepth) + " nested calls"};
+        }
+
+        // Dynamic dispatch on the receiver's runtime class, remembered for the next call from here
+        MethodCode* method = code->cachedMethod;
+        if (code->cachedClass != receiver->layout) {
+            int index;
+            const MethodInfo* info = receiver->layout->findMethod(node->value, index);
+            if (!info) {
+                throw RuntimeError{node->lineno, "undefined method '" + node->value + "'"};
+            }
+            method = methodCode(node, info->node, &classes.at(info->ownerClass));
+            code->cachedClass = receiver->layout;
+            code->cachedMethod = method;
+        }
+
+        Node* params = method->params;
+        size_t paramCount = params ? params->children.size() : 0;
+        if (paramCount != argCount) {
+            throw RuntimeError{node->lineno, "wrong number of arguments to '" + node->value + "'"};
+        }
+
+        // Parameters take slots 1..n in declaration order, so the arguments are
+        // already in place. A parameter declared twice has a single slot, which
+        // gets the last argument passed for it as in the native code.
+        const FrameLayout& layout = *method->layout;
+        int lastParam = 0;
+        if (params) {
+            int position = 1;
+            for (auto param : params->children) {
+                int slot = layout.findSlot(param->value);
+                checkStore(node, param->value, stack[base + position], layout.references[slot]);
+                if (slot != position) stack[base + slot] = stack[base + position];
+                lastParam = std::max(lastParam, slot);
+                position++;
+            }
+        }
+        // Clear whatever follows the parameters before the locals take it
+        stack.resize(base + 1 + lastParam);
+        stack.resize(base + layout.size);
+
+        callDepth++;
+        frames.push_back(Frame{&layout, base});
+        task.step = argCount + 2;
+        tasks.push_back(Task{method->body, 0, stack.size()});
+    }
+};
+
+} // namespace
+
+void HeapStats::print(std::ostream& out) const {
+    out << "Heap: " << allocations << " allocations (" << bytesAllocated << " bytes) in "
+        << heapSize << "-byte semispaces, " << collections << " collection(s), "
+        << liveBytes << " bytes live after the last one\n";
+    out << "GC pauses: " << totalPause << " ms in total, longest " << longestPause << " ms\n";
+}
+
+bool evaluateProgram(Node* root, const SymbolTable& symbolTable, HeapStats* stats) {
+    if (!root) return false;
+
+    HeapStats unused;
+    Evaluator evaluator(symbolTable, stats ? *stats : unused);
+    return evaluator.run(root);
+}
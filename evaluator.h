@@ -0,0 +1,32 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <cstddef>
+#include <iostream>
+#include "Node.h"
+#include "symboltable.h"
+
+// What the evaluator's managed heap did during a run, see -mem-stats
+struct HeapStats {
+    size_t allocations = 0;    // Objects and arrays created
+    size_t bytesAllocated = 0;
+    size_t collections = 0;
+    size_t liveBytes = 0;      // Surviving the last collection
+    size_t heapSize = 0;       // Size of each semispace at the end of the run
+    double totalPause = 0;     // Time spent collecting, in milliseconds
+    double longestPause = 0;
+
+    void print(std::ostream& out) const;
+};
+
+// Runs the program by walking the AST directly. This is the reference
+// semantics the -emit-asm back end is tested against, and its speed is the
+// baseline that back end is measured against. Returns false if the program
+// could not be run or stopped with a runtime exception (printed to std::cerr).
+// Frames are laid out as buildSymbolTable assigned their slots, in one value
+// stack, and calls do not recurse in C++: recursion about two million calls
+// deep runs before it stops with a stack overflow. Objects and arrays live in
+// a garbage-collected heap, whose activity goes to 'stats' if given.
+bool evaluateProgram(Node* root, const SymbolTable& symbolTable, HeapStats* stats = nullptr);
+
+#endif // EVALUATOR_H
@@ -0,0 +1,251 @@
+#include "inliner.h"
+#include "classlayout.h"
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+// Context of the method currently being rewritten
+struct CallerContext {
+    std::string className;
+    const Node* method = nullptr; // MethodDeclaration or MainMethod, whose frame resolves names
+};
+
+int countNodes(Node* node) {
+    int count = 1;
+    for (auto child : node->children) {
+        count += countNodes(child);
+    }
+    return count;
+}
+
+bool usesThis(Node* node) {
+    if (node->type == "This") return true;
+    for (auto child : node->children) {
+        if (usesThis(child)) return true;
+    }
+    return false;
+}
+
+// An expression is pure if evaluating it has no side effects beyond reading variables
+bool isPure(Node* node) {
+    if (node->type == "MethodCall" || node->type == "NewObject" || node->type == "NewArray") {
+        return false;
+    }
+    for (auto child : node->children) {
+        if (!isPure(child)) return false;
+    }
+    return true;
+}
+
+// True if evaluating the expression can throw (null or out of bounds). Such an
+// argument cannot be inlined: the body may not use it, or use it later.
+bool canThrow(Node* node) {
+    if (node->type == "ArrayAccess" || node->type == "Length" || node->type == "FieldRead") {
+        return true;
+    }
+    for (auto child : node->children) {
+        if (canThrow(child)) return true;
+    }
+    return false;
+}
+
+bool readsFields(Node* node, const std::unordered_map<std::string, Node*>& arguments) {
+    if (node->type == "Identifier" && !arguments.count(node->value)) return true;
+    for (auto child : node->children) {
+        if (readsFields(child, arguments)) return true;
+    }
+    return false;
+}
+
+Node* clone(Node* node, int lineno) {
+    Node* copy = new Node(node->type, node->value, lineno);
+    for (auto child : node->children) {
+        copy->children.push_back(clone(child, lineno));
+    }
+    return copy;
+}
+
+// Copies a method body into the caller. Parameters become the arguments, 'this'
+// becomes the receiver and every other name, a field of ownerClass, becomes a
+// FieldRead of the receiver: the field 'value' of the object in the first
+// child, as laid out by the class named in the second.
+Node* cloneInto(Node* node, const std::unordered_map<std::string, Node*>& arguments, Node* receiver,
+                const std::string& ownerClass, int lineno) {
+    if (node->type == "Identifier") {
+        auto it = arguments.find(node->value);
+        if (it != arguments.end()) {
+            return clone(it->second, lineno);
+        }
+        Node* field = new Node("FieldRead", node->value, lineno);
+        field->children.push_back(clone(receiver, lineno));
+        field->children.push_back(new Node("Type", ownerClass, lineno));
+        return field;
+    }
+    if (node->type == "This") {
+        return clone(receiver, lineno);
+    }
+
+    Node* copy = new Node(node->type, node->value, lineno);
+    for (auto child : node->children) {
+        copy->children.push_back(cloneInto(child, arguments, receiver, ownerClass, lineno));
+    }
+    return copy;
+}
+
+class Inliner {
+public:
+    Inliner(Node* root, SymbolTable& symbolTable, int budget)
+        : symbolTable(symbolTable), budget(budget), inlined(0) {
+        std::string error;
+        int errorLine = 0;
+        // The hierarchy was checked by semantic analysis, a broken one just disables inlining
+        if (!buildClassLayouts(root, classes, error, errorLine)) {
+            classes.clear();
+        }
+    }
+
+    int run(Node* root) {
+        CallerContext context;
+        rewrite(root, context);
+        return inlined;
+    }
+
+private:
+    SymbolTable& symbolTable;
+    int budget;
+    int inlined;
+    ClassLayouts classes;
+
+    // Static lookup of a method through the vtable of the receiver's class
+    const MethodInfo* resolveMethod(const std::string& className, const std::string& methodName) {
+        auto layout = classes.find(className);
+        if (layout == classes.end()) return nullptr;
+        int index;
+        return layout->second.findMethod(methodName, index);
+    }
+
+    // True if some subclass of the receiver's static type dispatches the method to another body
+    bool isOverridden(const std::string& staticType, const MethodInfo& method) {
+        for (const auto& entry : classes) {
+            if (!symbolTable.isSubtype(entry.first, staticType)) continue;
+            int index;
+            const MethodInfo* dispatched = entry.second.findMethod(method.name, index);
+            if (dispatched && dispatched->node != method.node) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Static type of a receiver the inliner can reason about, empty for any other expression
+    std::string receiverType(Node* receiver, const CallerContext& context) {
+        if (receiver->type == "This") return context.className;
+        if (receiver->type == "NewObject") return receiver->value;
+        if (receiver->type == "Identifier") {
+            // A parameter or local of the caller, else a field of its class
+            VariableSymbol* variable = symbolTable.findVariable(receiver->value, context.method, context.className);
+            return variable ? variable->type : "";
+        }
+        if (receiver->type == "FieldRead") {
+            // A getter inlined earlier, typed by the class it reads from
+            auto layout = classes.find(receiver->children.back()->value);
+            std::string type;
+            if (layout == classes.end() || layout->second.findField(receiver->value, type) < 0) return "";
+            return type;
+        }
+        return "";
+    }
+
+    // Returns the replacement expression for a call, or nullptr if it cannot be inlined
+    Node* tryInline(Node* call, const CallerContext& context) {
+        Node* receiver = call->children.front();
+        std::string staticType = receiverType(receiver, context);
+        if (staticType.empty()) return nullptr;
+
+        const MethodInfo* info = resolveMethod(staticType, call->value);
+        if (!info || isOverridden(staticType, *info)) return nullptr;
+        Node* method = info->node;
+        const std::string& ownerClass = info->ownerClass;
+
+        // Only methods whose whole body is a single return statement
+        Node* varList = findChild(method, "VarDeclarationList");
+        if (findChild(method, "StatementList") || (varList && !varList->children.empty())) return nullptr;
+        Node* returnNode = method->children.back();
+        if (returnNode->type != "Return" || returnNode->children.empty()) return nullptr;
+
+        Node* body = returnNode->children.front();
+        if (countNodes(body) > budget || !isPure(body)) return nullptr;
+
+        // Bind arguments to parameters. Arguments may be duplicated, reordered or
+        // dropped, so they must be pure and unable to throw.
+        std::unordered_map<std::string, Node*> arguments;
+        Node* paramList = findChild(method, "ParameterList");
+        Node* argList = call->children.size() > 1 ? call->children.back() : nullptr;
+        size_t paramCount = paramList ? paramList->children.size() : 0;
+        size_t argCount = argList ? argList->children.size() : 0;
+        if (paramCount != argCount) return nullptr;
+
+        if (paramList) {
+            auto argIt = argList->children.begin();
+            for (auto param : paramList->children) {
+                if (!isPure(*argIt) || canThrow(*argIt)) return nullptr;
+                arguments[param->value] = *argIt++;
+            }
+        }
+
+        // The call throws if its receiver is null. 'this' never is, and a new
+        // object is unused unless the body reads it, so both can be dropped or
+        // copied. Any other receiver must be read exactly once, by a FieldRead
+        // that does the null check: only a plain getter is inlined for it.
+        bool usesReceiver = usesThis(body) || readsFields(body, arguments);
+        if (receiver->type == "NewObject") {
+            if (usesReceiver) return nullptr;
+        } else if (receiver->type != "This") {
+            if (body->type != "Identifier" || arguments.count(body->value)) return nullptr;
+        }
+
+        return cloneInto(body, arguments, receiver, ownerClass, call->lineno);
+    }
+
+    void rewrite(Node* node, CallerContext& context) {
+        if (node->type == "ClassDeclaration" || node->type == "MainClass") {
+            CallerContext classContext;
+            classContext.className = node->value;
+            for (auto child : node->children) {
+                rewrite(child, classContext);
+            }
+            return;
+        }
+
+        if (node->type == "MethodDeclaration" || node->type == "MainMethod") {
+            CallerContext methodContext;
+            methodContext.className = context.className;
+            methodContext.method = node;
+            for (auto child : node->children) {
+                rewrite(child, methodContext);
+            }
+            return;
+        }
+
+        // Rewrite children bottom-up so arguments are already inlined when the call is visited
+        for (auto it = node->children.begin(); it != node->children.end(); ++it) {
+            rewrite(*it, context);
+            if ((*it)->type == "MethodCall") {
+                Node* replacement = tryInline(*it, context);
+                if (replacement) {
+                    *it = replacement;
+                    inlined++;
+                }
+            }
+        }
+    }
+};
+
+} // namespace
+
+int inlineSmallMethods(Node* root, SymbolTable& symbolTable, int budget) {
+    if (!root) return 0;
+    Inliner inliner(root, symbolTable, budget);
+    return inliner.run(root);
+}
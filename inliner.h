@@ -0,0 +1,18 @@
+#ifndef INLINER_H
+#define INLINER_H
+
+#include "Node.h"
+#include "symboltable.h"
+
+// Default size budget (AST nodes in the returned expression) for an inlined method
+const int DEFAULT_INLINE_BUDGET = 8;
+
+// Replaces calls to small, non-overridden accessor methods with their returned
+// expression. Fields the method reads become FieldRead nodes (field name as the
+// value, the receiver and a Type naming the declaring class as children), which
+// the evaluator and the code generator null-check. Must run on a tree that
+// passed semantic analysis, so the class hierarchy in the symbol table is
+// built. Returns the number of inlined calls.
+int inlineSmallMethods(Node* root, SymbolTable& symbolTable, int budget = DEFAULT_INLINE_BUDGET);
+
+#endif // INLINER_H
@@ -1,12 +1,15 @@
 #include <iostream>
+#include <chrono>
 #include "parser.tab.hh"
 #include "symboltable.h"
+#include "inliner.h"
+#include "codegen.h"
+#include "evaluator.h"
+#include "tokenpipeline.h"
 
 extern Node *root;
 extern FILE *yyin;
-extern int yylineno;
 extern int lexical_errors;
-extern yy::parser::symbol_type yylex();
 
 enum errCodes
 {
@@ -15,18 +18,40 @@ enum errCodes
 	SYNTAX_ERROR = 2,
 	AST_ERROR = 3,
 	SEMANTIC_ERROR = 4,
+	RUNTIME_ERROR = 5,
 	SEGMENTATION_FAULT = 139
 };
 
 int errCode = errCodes::SUCCESS;
 
+// Starts Graphviz on a DOT file without waiting for it. The intermediate child
+// exits right away so the renderer is re-parented and never blocks the compiler.
+void renderInBackground(const char *dotFile, const char *pdfFile)
+{
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		if (fork() == 0)
+		{
+			std::string output = std::string("-o") + pdfFile;
+			execlp("dot", "dot", "-Tpdf", dotFile, output.c_str(), (char *)nullptr);
+			_exit(127);
+		}
+		_exit(0);
+	}
+	else if (pid > 0)
+	{
+		waitpid(pid, nullptr, 0);
+	}
+}
+
 // Handling Syntax Errors
 void yy::parser::error(std::string const &err)
 {
 	if (!lexical_errors)
 	{
 		std::cerr << "Syntax errors found! See the logs below:" << std::endl;
-		std::cerr << "\t@error at line " << yylineno << ". Cannot generate a syntax for this input:" << err.c_str() << std::endl;
+		std::cerr << "\t@error at line " << tokenLine << ". Cannot generate a syntax for this input:" << err.c_str() << std::endl;
 		std::cerr << "End of syntax errors!" << std::endl;
 		errCode = errCodes::SYNTAX_ERROR;
 	}
@@ -38,6 +63,17 @@ int main(int argc, char **argv)
 	bool doSemanticAnalysis = false;
 	bool printSymbolTable = false;
 	bool generateDotFile = false;
+	bool generateJsonFile = false;
+	bool renderDotFile = false;
+	bool inlineMethods = false;
+	bool jsonDiagnostics = false;
+	int maxErrors = 0;
+	bool printMemoryStats = false;
+	bool emitAssembly = false;
+	bool runProgram = false;
+	bool pipelineLexer = false;
+	bool printParseTime = false;
+	int inlineBudget = DEFAULT_INLINE_BUDGET;
 
 	// Parse command-line arguments
 	for (int i = 1; i < argc; i++)
@@ -54,6 +90,53 @@ int main(int argc, char **argv)
 		{
 			generateDotFile = true;
 		}
+		else if (std::string(argv[i]) == "-st-json")
+		{
+			generateJsonFile = true;
+		}
+		else if (std::string(argv[i]) == "-st-render")
+		{
+			generateDotFile = true;
+			renderDotFile = true;
+		}
+		else if (std::string(argv[i]) == "-inline")
+		{
+			// Inlining needs a type-checked tree
+			inlineMethods = true;
+			doSemanticAnalysis = true;
+		}
+		else if (std::string(argv[i]) == "-inline-budget" && i + 1 < argc)
+		{
+			inlineBudget = std::atoi(argv[++i]);
+		}
+		else if (std::string(argv[i]) == "-max-errors" && i + 1 < argc)
+		{
+			maxErrors = std::atoi(argv[++i]);
+		}
+		else if (std::string(argv[i]) == "-diagnostics-json")
+		{
+			jsonDiagnostics = true;
+		}
+		else if (std::string(argv[i]) == "-mem-stats")
+		{
+			printMemoryStats = true;
+		}
+		else if (std::string(argv[i]) == "-emit-asm")
+		{
+			emitAssembly = true;
+		}
+		else if (std::string(argv[i]) == "-run")
+		{
+			runProgram = true;
+		}
+		else if (std::string(argv[i]) == "-pipeline")
+		{
+			pipelineLexer = true;
+		}
+		else if (std::string(argv[i]) == "-parse-time")
+		{
+			printParseTime = true;
+		}
 	}
 
 	// Reads from file if a file name is passed as an argument. Otherwise, reads from stdin.
@@ -73,8 +156,22 @@ int main(int argc, char **argv)
 	}
 	else
 	{
+		// Scan on a separate thread, ahead of the parser, if requested
+		if (pipelineLexer)
+		{
+			startTokenPipeline();
+		}
+
+		auto parseStart = std::chrono::steady_clock::now();
 		yy::parser parser;
 		bool parseSuccess = !parser.parse();
+		stopTokenPipeline();
+		std::chrono::duration<double, std::milli> parseTime = std::chrono::steady_clock::now() - parseStart;
+
+		if (printParseTime)
+		{
+			std::cerr << "Parse time: " << parseTime.count() << " ms\n";
+		}
 
 		if (lexical_errors)
 		{
@@ -89,15 +186,17 @@ int main(int argc, char **argv)
 			{
 				// Print and generate AST
 				printf("\nPrint Tree:  \n");
-				root->print_tree();
-				root->generate_tree();
+				root->print_and_generate_tree();
 
 				// Symbol table and semantic analysis phase
-				if (doSemanticAnalysis || printSymbolTable || generateDotFile)
+				// The back ends take their frame layouts from the symbol table, so it is built for them too
+				bool semanticSuccess = true;
+				bool reportSymbolTable = doSemanticAnalysis || printSymbolTable || generateDotFile || generateJsonFile;
+				SymbolTable symbolTable;
+				if (reportSymbolTable || emitAssembly || runProgram)
 				{
-					// Create the symbol table
-					// Create the symbol table
-					SymbolTable symbolTable;
+					Diagnostics &diagnostics = symbolTable.getDiagnostics();
+					diagnostics.setMaxErrors(maxErrors);
 
 					// Build the symbol table by traversing the AST
 					buildSymbolTable(root, symbolTable);
@@ -108,31 +207,93 @@ int main(int argc, char **argv)
 						symbolTable.printSymbols();
 					}
 
-					// Generate DOT file for the symbol table if requested
-					if (generateDotFile)
+					// Generate DOT file for the symbol table if requested, rendering is left to 'make st'
+					if (generateDotFile && symbolTable.generateDotFile("symboltable.dot"))
 					{
-						symbolTable.generateDotFile("symboltable.dot");
-						system("dot -Tpdf symboltable.dot -osymboltable.pdf");
-						std::cout << "Symbol table visualization saved to symboltable.pdf\n";
+						if (renderDotFile)
+						{
+							renderInBackground("symboltable.dot", "symboltable.pdf");
+							std::cout << "Rendering symbol table to symboltable.pdf in the background\n";
+						}
+						else
+						{
+							std::cout << "Use 'make st' to generate the pdf version.\n";
+						}
+					}
+
+					if (generateJsonFile)
+					{
+						symbolTable.generateJsonFile("symboltable.json");
 					}
 
 					// Perform semantic analysis if requested
 					if (doSemanticAnalysis)
 					{
 						std::cout << "\nPerforming Semantic Analysis...\n";
-						bool semanticSuccess = performSemanticAnalysis(root, symbolTable);
 
+						// Index the class hierarchy once so subtype checks are constant time
+						symbolTable.buildClassHierarchy();
+						performSemanticAnalysis(root, symbolTable);
+					}
+
+					// Report everything found while building and checking the table in one batch
+					if (reportSymbolTable && jsonDiagnostics)
+					{
+						diagnostics.printJson(std::cerr);
+					}
+					else if (reportSymbolTable)
+					{
+						diagnostics.print(std::cerr, "Semantic");
+					}
+
+					if (doSemanticAnalysis)
+					{
+						semanticSuccess = !diagnostics.hasErrors();
 						if (!semanticSuccess)
 						{
-							std::cerr << "Semantic analysis failed with errors.\n";
+							// With -diagnostics-json stderr holds nothing but the JSON report
+							if (!jsonDiagnostics)
+							{
+								std::cerr << "Semantic analysis failed with errors.\n";
+							}
 							errCode = errCodes::SEMANTIC_ERROR;
 						}
 						else
 						{
 							std::cout << "Semantic analysis completed successfully!\n";
+
+							if (inlineMethods)
+							{
+								int inlinedCalls = inlineSmallMethods(root, symbolTable, inlineBudget);
+								std::cout << "Inlined " << inlinedCalls << " method call(s)\n";
+							}
 						}
 					}
 				}
+
+				// Native code generation, skipped if semantic analysis was requested and failed
+				if (emitAssembly && semanticSuccess && !generateAssembly(root, symbolTable, "output.s"))
+				{
+					errCode = errCodes::AST_ERROR;
+				}
+
+				// Reference evaluation of the tree, the program's output follows the marker line
+				if (runProgram && semanticSuccess)
+				{
+					std::cout << "\nProgram output:\n";
+					auto start = std::chrono::steady_clock::now();
+					HeapStats heapStats;
+					if (!evaluateProgram(root, symbolTable, &heapStats))
+					{
+						errCode = errCodes::RUNTIME_ERROR;
+					}
+					std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+					std::cerr << "Evaluation time: " << elapsed.count() << " ms\n";
+					if (printMemoryStats)
+					{
+						heapStats.print(std::cerr);
+					}
+				}
 			}
 			catch (...)
 			{
@@ -23,19 +23,21 @@
   
   // Global pointer to the root AST node.
   Node* root;
-  // External variable for tracking current line number.
-  extern int yylineno;
+  // Line of the current token, kept by yylex() (see tokenpipeline.h).
+  extern int tokenLine;
 }
 
 /* Token definitions */
 // Define tokens for operators, parenthesis, punctuation, and reserved keywords.
-%token <std::string> PLUS MINUS MULT AND OR LT GT EQ ASSIGN NOT DOT
-%token <std::string> LPAREN RPAREN LBRACE RBRACE LBRACKET RBRACKET
-%token <std::string> SEMICOLON COMMA
-%token <std::string> PUBLIC CLASS STATIC VOID MAIN STRING RETURN
-%token <std::string> INT_TYPE BOOLEAN IF ELSE WHILE PRINTLN LENGTH
-%token <std::string> TRUE FALSE THIS NEW EXTENDS
-%token <std::string> INTEGER_LITERAL IDENTIFIER
+// Their kind says all there is to know, so they carry no value.
+%token PLUS MINUS MULT AND OR LT GT EQ ASSIGN NOT DOT
+%token LPAREN RPAREN LBRACE RBRACE LBRACKET RBRACKET
+%token SEMICOLON COMMA
+%token PUBLIC CLASS STATIC VOID MAIN STRING RETURN
+%token INT_TYPE BOOLEAN IF ELSE WHILE PRINTLN LENGTH
+%token TRUE FALSE THIS NEW EXTENDS
+// Literals and identifiers carry their text, interned by the scanner (see internText)
+%token <const std::string*> INTEGER_LITERAL IDENTIFIER
 %token END 0 "end of file"
 
 /* Operator precedence and associativity */
@@ -65,7 +67,7 @@
 %%
 
 goal: main_class class_declaration_list END { 
-    $$ = new Node("Goal", "", yylineno);
+    $$ = new Node("Goal", "", tokenLine);
     $$->children.push_back($1);
     if($2) $$->children.push_back($2);
     root = $$;
@@ -75,9 +77,9 @@ goal: main_class class_declaration_list END {
 main_class: PUBLIC CLASS IDENTIFIER LBRACE PUBLIC STATIC VOID MAIN 
             LPAREN STRING LBRACKET RBRACKET IDENTIFIER RPAREN 
             LBRACE statement_list RBRACE RBRACE {
-                $$ = new Node("MainClass", $3, yylineno);
+                $$ = new Node("MainClass", *$3, tokenLine);
                 // Create a 'MainMethod' node containing the statements.
-                Node* mainMethod = new Node("MainMethod", "", yylineno);
+                Node* mainMethod = new Node("MainMethod", "", tokenLine);
                 mainMethod->children.push_back($16); // Statements block inside main.
                 $$->children.push_back(mainMethod);
             }
@@ -85,14 +87,14 @@ main_class: PUBLIC CLASS IDENTIFIER LBRACE PUBLIC STATIC VOID MAIN
 
 // Declares a class with its variables and methods. Two forms for with/without inheritance.
 class_declaration: CLASS IDENTIFIER LBRACE var_declaration_list method_declaration_list RBRACE {
-    $$ = new Node("ClassDeclaration", $2, yylineno);
+    $$ = new Node("ClassDeclaration", *$2, tokenLine);
     if($4) $$->children.push_back($4); // Variables.
     if($5) $$->children.push_back($5); // Methods.
     }
     | CLASS IDENTIFIER EXTENDS IDENTIFIER LBRACE var_declaration_list method_declaration_list RBRACE {
-    $$ = new Node("ClassDeclaration", $2, yylineno);
+    $$ = new Node("ClassDeclaration", *$2, tokenLine);
     // Build an "Extends" node for the parent class.
-    Node* extends = new Node("Extends", $4, yylineno);
+    Node* extends = new Node("Extends", *$4, tokenLine);
     $$->children.push_back(extends);
     if($6) $$->children.push_back($6);
     if($7) $$->children.push_back($7);
@@ -105,7 +107,7 @@ class_declaration: CLASS IDENTIFIER LBRACE var_declaration_list method_declarati
 class_declaration_list: /* empty */ { $$ = nullptr; }
     | class_declaration_list class_declaration {
         if($1 == nullptr) {
-            $$ = new Node("ClassDeclarationList", "", yylineno);
+            $$ = new Node("ClassDeclarationList", "", tokenLine);
         } else {
             $$ = $1;
         }
@@ -115,50 +117,50 @@ class_declaration_list: /* empty */ { $$ = nullptr; }
 
 
 // The type productions handle array types, primitive types, and identifiers as types.
-type: INT_TYPE LBRACKET RBRACKET { $$ = new Node("ArrayType", "int[]", yylineno); }
-    | BOOLEAN { $$ = new Node("Type", "boolean", yylineno); }
-    | INT_TYPE { $$ = new Node("Type", "int", yylineno); }
-    | IDENTIFIER { $$ = new Node("Type", $1, yylineno); }
+type: INT_TYPE LBRACKET RBRACKET { $$ = new Node("ArrayType", "int[]", tokenLine); }
+    | BOOLEAN { $$ = new Node("Type", "boolean", tokenLine); }
+    | INT_TYPE { $$ = new Node("Type", "int", tokenLine); }
+    | IDENTIFIER { $$ = new Node("Type", *$1, tokenLine); }
     ;
 
 // Basic expressions (literals, identifiers, etc.)
-factor: INTEGER_LITERAL  { $$ = new Node("Int", $1, yylineno); }
+factor: INTEGER_LITERAL  { $$ = new Node("Int", *$1, tokenLine); }
       | LPAREN expression RPAREN { $$ = $2; }
-      | IDENTIFIER { $$ = new Node("Identifier", $1, yylineno); }
-      | TRUE { $$ = new Node("Boolean", "true", yylineno); }
-      | FALSE { $$ = new Node("Boolean", "false", yylineno); }
-      | THIS { $$ = new Node("This", "", yylineno); }
+      | IDENTIFIER { $$ = new Node("Identifier", *$1, tokenLine); }
+      | TRUE { $$ = new Node("Boolean", "true", tokenLine); }
+      | FALSE { $$ = new Node("Boolean", "false", tokenLine); }
+      | THIS { $$ = new Node("This", "", tokenLine); }
       ;
 
 
 // Various statement kinds are defined here.
 statement: LBRACE statement_list RBRACE { $$ = $2; }
          | IF LPAREN expression RPAREN statement ELSE statement {
-                $$ = new Node("IfStatement", "", yylineno);
+                $$ = new Node("IfStatement", "", tokenLine);
                 $$->children.push_back($3); // Condition.
                 $$->children.push_back($5); // 'Then' branch.
                 $$->children.push_back($7); // 'Else' branch.
          }
          | IF LPAREN expression RPAREN statement {
-                $$ = new Node("IfStatement", "", yylineno);
+                $$ = new Node("IfStatement", "", tokenLine);
                 $$->children.push_back($3); // Condition.
                 $$->children.push_back($5); // 'Then' branch.
          }
          | WHILE LPAREN expression RPAREN statement {
-                $$ = new Node("WhileStatement", "", yylineno);
+                $$ = new Node("WhileStatement", "", tokenLine);
                 $$->children.push_back($3); // Loop condition.
                 $$->children.push_back($5); // Loop body.
          }
          | PRINTLN LPAREN expression RPAREN SEMICOLON {
-                $$ = new Node("PrintStatement", "", yylineno);
+                $$ = new Node("PrintStatement", "", tokenLine);
                 $$->children.push_back($3); // Expression to print.
          }
          | IDENTIFIER ASSIGN expression SEMICOLON {
-                $$ = new Node("AssignStatement", $1, yylineno);
+                $$ = new Node("AssignStatement", *$1, tokenLine);
                 $$->children.push_back($3); // Right-hand side value.
          }
          | IDENTIFIER LBRACKET expression RBRACKET ASSIGN expression SEMICOLON {
-                $$ = new Node("ArrayAssignStatement", $1, yylineno);
+                $$ = new Node("ArrayAssignStatement", *$1, tokenLine);
                 $$->children.push_back($3); // Array index.
                 $$->children.push_back($6); // Value assigned.
          }
@@ -168,7 +170,7 @@ statement: LBRACE statement_list RBRACE { $$ = $2; }
 
 // A list of statements.
 statement_list: statement { 
-        $$ = new Node("StatementList", "", yylineno);
+        $$ = new Node("StatementList", "", tokenLine);
         $$->children.push_back($1);
     }
     | statement_list statement {
@@ -180,11 +182,11 @@ statement_list: statement {
 // Variable declarations can be simple or arrays.
 var_declaration:
     type IDENTIFIER SEMICOLON {
-        $$ = new Node("VarDeclaration", $2, yylineno);
+        $$ = new Node("VarDeclaration", *$2, tokenLine);
         $$->children.push_back($1); // Variable type.
     }
     | type IDENTIFIER LBRACKET RBRACKET SEMICOLON { 
-        $$ = new Node("ArrayDeclaration", $2, yylineno);
+        $$ = new Node("ArrayDeclaration", *$2, tokenLine);
         $$->children.push_back($1); // Variable type.
     }
     ;
@@ -192,9 +194,9 @@ var_declaration:
 
 // A list of variable declarations.
 var_declaration_list: 
-      /* empty */ { $$ = new Node("VarDeclarationList", "", yylineno); }
+      /* empty */ { $$ = new Node("VarDeclarationList", "", tokenLine); }
     | var_declaration_list var_declaration {
-        $$ = new Node("VarDeclarationList", "", yylineno);
+        $$ = new Node("VarDeclarationList", "", tokenLine);
           $1->children.push_back($2);
           $$ = $1;
 
@@ -207,7 +209,7 @@ method_declaration:
     PUBLIC type IDENTIFIER LPAREN parameter_list RPAREN 
     LBRACE var_declaration_list statement_list RETURN expression SEMICOLON RBRACE {
         // First, create the method node.
-        $$ = new Node("MethodDeclaration", $3, yylineno);
+        $$ = new Node("MethodDeclaration", *$3, tokenLine);
         $$->children.push_back($2);        // Return type
         if($5) $$->children.push_back($5);   // Parameters
         if($8) $$->children.push_back($8);   // Variable declarations
@@ -215,18 +217,18 @@ method_declaration:
         
         // Enforce a return statement for non-void methods.
         if ($2->value != "void") {
-            Node* returnNode = new Node("Return", "", yylineno);
+            Node* returnNode = new Node("Return", "", tokenLine);
             returnNode->children.push_back($11); // Return expression
             $$->children.push_back(returnNode);
         }
     }
     | PUBLIC type IDENTIFIER LPAREN parameter_list RPAREN 
       LBRACE RETURN expression SEMICOLON RBRACE {
-        $$ = new Node("MethodDeclaration", $3, yylineno);
+        $$ = new Node("MethodDeclaration", *$3, tokenLine);
         $$->children.push_back($2);        // Return type
         if($5) $$->children.push_back($5);   // Parameters
         
-        Node* returnNode = new Node("Return", "", yylineno);
+        Node* returnNode = new Node("Return", "", tokenLine);
         returnNode->children.push_back($9);
         $$->children.push_back(returnNode);
     }
@@ -237,7 +239,7 @@ method_declaration:
 method_declaration_list: /* empty */ { $$ = nullptr; }
     | method_declaration_list method_declaration {
         if($1 == nullptr) {
-            $$ = new Node("MethodDeclarationList", "", yylineno);
+            $$ = new Node("MethodDeclarationList", "", tokenLine);
         } else {
             $$ = $1;
         }
@@ -249,13 +251,13 @@ method_declaration_list: /* empty */ { $$ = nullptr; }
 parameter_list: 
     /* empty */ { $$ = nullptr; }
     | type IDENTIFIER { 
-        $$ = new Node("ParameterList", "", yylineno);
-        Node* param = new Node("Parameter", $2, yylineno);
+        $$ = new Node("ParameterList", "", tokenLine);
+        Node* param = new Node("Parameter", *$2, tokenLine);
         param->children.push_back($1); // Parameter type.
         $$->children.push_back(param);
     }
     | parameter_list COMMA type IDENTIFIER {
-        Node* param = new Node("Parameter", $4, yylineno);
+        Node* param = new Node("Parameter", *$4, tokenLine);
         param->children.push_back($3);
         $1->children.push_back(param);
         $$ = $1;
@@ -264,70 +266,70 @@ parameter_list:
 
 // Expression productions build nodes for arithmetic, logical, and other operations.
 expression: expression AND expression {
-        $$ = new Node("AndExpression", "", yylineno);
+        $$ = new Node("AndExpression", "", tokenLine);
         $$->children.push_back($1);
         $$->children.push_back($3);
     }
     | expression OR expression {
-        $$ = new Node("OrExpression", "", yylineno);
+        $$ = new Node("OrExpression", "", tokenLine);
         $$->children.push_back($1);
         $$->children.push_back($3);
     }
     | expression LT expression {
-        $$ = new Node("LessThanExpression", "", yylineno);
+        $$ = new Node("LessThanExpression", "", tokenLine);
         $$->children.push_back($1);
         $$->children.push_back($3);
     }
     | expression EQ expression {
-        $$ = new Node("EqualExpression", "", yylineno);
+        $$ = new Node("EqualExpression", "", tokenLine);
         $$->children.push_back($1);
         $$->children.push_back($3);
     }
     | expression PLUS expression {
-        $$ = new Node("AddExpression", "", yylineno);
+        $$ = new Node("AddExpression", "", tokenLine);
         $$->children.push_back($1);
         $$->children.push_back($3);
     }
     | expression MINUS expression {
-        $$ = new Node("SubExpression", "", yylineno);
+        $$ = new Node("SubExpression", "", tokenLine);
         $$->children.push_back($1);
         $$->children.push_back($3);
     }
     | expression MULT expression {
-        $$ = new Node("MultExpression", "", yylineno);
+        $$ = new Node("MultExpression", "", tokenLine);
         $$->children.push_back($1);
         $$->children.push_back($3);
     }
     | factor { $$ = $1; } // Base case: a factor.
     | expression LBRACKET expression RBRACKET { 
         // Represents an array access: array[expression]
-        $$ = new Node("ArrayAccess", "", yylineno);
+        $$ = new Node("ArrayAccess", "", tokenLine);
         $$->children.push_back($1); // Array operand.
         $$->children.push_back($3); // Index expression.
     }
     | expression DOT LENGTH {
         // Get the length of an array.
-        $$ = new Node("Length", "", yylineno);
+        $$ = new Node("Length", "", tokenLine);
         $$->children.push_back($1);
     }
     | expression DOT IDENTIFIER LPAREN expression_list RPAREN {
         // Method call on an object with parameters.
-        $$ = new Node("MethodCall", $3, yylineno);
+        $$ = new Node("MethodCall", *$3, tokenLine);
         $$->children.push_back($1); // The caller object.
         if($5) $$->children.push_back($5); // Optional argument list.
     }
     | NEW INT_TYPE LBRACKET expression RBRACKET {
         // Create a new array.
-        $$ = new Node("NewArray", "", yylineno);
+        $$ = new Node("NewArray", "", tokenLine);
         $$->children.push_back($4); // The size of the array.
     }
     | NEW IDENTIFIER LPAREN RPAREN {
         // Create a new object.
-        $$ = new Node("NewObject", $2, yylineno);
+        $$ = new Node("NewObject", *$2, tokenLine);
     }
     | NOT expression {
         // Logical NOT expression.
-        $$ = new Node("NotExpression", "", yylineno);
+        $$ = new Node("NotExpression", "", tokenLine);
         $$->children.push_back($2);
     }
     
@@ -342,7 +344,7 @@ expression_list:
 
 expression_list_nonempty:
     expression { 
-        $$ = new Node("ExpressionList", "", yylineno);
+        $$ = new Node("ExpressionList", "", tokenLine);
         $$->children.push_back($1);
     }
   | expression_list_nonempty COMMA expression {
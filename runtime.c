@@ -0,0 +1,128 @@
+/* Runtime support for executables built from the output of -emit-asm. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Entry point of the generated code (the MiniJava main method) */
+extern void mj_main(void);
+
+/* MiniJava code runs on a stack of its own, deep enough for millions of nested
+   calls. Pages are only committed as they are touched. */
+#define STACK_SIZE (1024L * 1024 * 1024)
+/* Inaccessible bottom of that stack, a fault in it is a stack overflow */
+#define GUARD_SIZE (1024L * 1024)
+
+static char *guard;
+
+/* Objects are a vtable pointer followed by 8-byte fields, zero-initialised */
+void *mj_new_object(long size, void *vtable)
+{
+	void **object = calloc(1, size);
+	if (!object)
+	{
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	object[0] = vtable;
+	return object;
+}
+
+/* Arrays are an 8-byte length followed by the elements */
+long *mj_new_array(long length)
+{
+	if (length < 0)
+	{
+		fflush(stdout);
+		fprintf(stderr, "Exception: negative array size %ld\n", length);
+		exit(1);
+	}
+	long *array = calloc(length + 1, sizeof(long));
+	if (!array)
+	{
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	array[0] = length;
+	return array;
+}
+
+void mj_array_bounds(void)
+{
+	fflush(stdout);
+	fprintf(stderr, "Exception: array index out of bounds\n");
+	exit(1);
+}
+
+/* A method called on, or a field or array read through, a null reference */
+void mj_null_pointer(void)
+{
+	fflush(stdout);
+	fprintf(stderr, "Exception: null pointer\n");
+	exit(1);
+}
+
+void mj_println(long value)
+{
+	printf("%ld\n", value);
+}
+
+/* Runs on the alternate signal stack. Overflows are reported like the other
+   exceptions, any other fault is left to the default action. */
+static void on_segv(int number, siginfo_t *info, void *context)
+{
+	char *address = info->si_addr;
+	if (guard && address >= guard && address < guard + GUARD_SIZE)
+	{
+		static const char message[] = "Exception: stack overflow\n";
+		/* Not async-signal-safe, but the program never resumes and its output
+		   so far should match what the evaluator prints before the same error */
+		fflush(stdout);
+		write(2, message, sizeof(message) - 1);
+		_exit(1);
+	}
+	(void)context;
+	signal(number, SIG_DFL);
+}
+
+static void *run_main(void *unused)
+{
+	static char alternate[64 * 1024];
+	stack_t signalStack = {.ss_sp = alternate, .ss_size = sizeof(alternate)};
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = on_segv;
+	action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+	sigaltstack(&signalStack, NULL);
+	sigaction(SIGSEGV, &action, NULL);
+
+	mj_main();
+	(void)unused;
+	return NULL;
+}
+
+int main(void)
+{
+	char *stack = mmap(NULL, STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	pthread_attr_t attributes;
+	pthread_t thread;
+	if (stack != MAP_FAILED && mprotect(stack, GUARD_SIZE, PROT_NONE) == 0)
+	{
+		guard = stack;
+		pthread_attr_init(&attributes);
+		pthread_attr_setstack(&attributes, stack, STACK_SIZE);
+		if (pthread_create(&thread, &attributes, run_main, NULL) == 0)
+		{
+			pthread_join(thread, NULL);
+			return 0;
+		}
+		guard = NULL;
+	}
+
+	/* Fall back to the process stack, where an overflow is an ordinary crash */
+	run_main(NULL);
+	return 0;
+}
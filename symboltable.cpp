@@ -1,31 +1,32 @@
 #include "symboltable.h"
+#include "classlayout.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 
 // Symbol implementation
-Symbol::Symbol(std::string name, std::string type, int scope)
-    : name(std::move(name)), type(std::move(type)), scope(scope) {}
+Symbol::Symbol(std::string name, std::string type, int scope, int lineno)
+    : name(std::move(name)), type(std::move(type)), scope(scope), lineno(lineno) {}
 
 void Symbol::printSymbol() const {
     std::cout << getKind() << " | Name: " << name << ", Type: " << type << ", Scope: " << scope << std::endl;
 }
 
 // ClassSymbol implementation
-ClassSymbol::ClassSymbol(std::string name, int scope, std::string parentClass)
-    : Symbol(std::move(name), "class", scope), parentClass(std::move(parentClass)) {}
+ClassSymbol::ClassSymbol(std::string name, int scope, std::string parentClass, int lineno)
+    : Symbol(std::move(name), "class", scope, lineno), parentClass(std::move(parentClass)) {}
 
 // MethodSymbol implementation
-MethodSymbol::MethodSymbol(std::string name, std::string returnType, int scope, std::string classOwner)
-    : Symbol(std::move(name), "method", scope), returnType(std::move(returnType)), classOwner(std::move(classOwner)) {}
+MethodSymbol::MethodSymbol(std::string name, std::string returnType, int scope, std::string classOwner, int lineno)
+    : Symbol(std::move(name), "method", scope, lineno), returnType(std::move(returnType)), classOwner(std::move(classOwner)), frameSize(1) {}
 
 void MethodSymbol::addParameter(std::string name, std::string type) {
     parameters.emplace_back(std::move(name), std::move(type));
 }
 
 // VariableSymbol implementation
-VariableSymbol::VariableSymbol(std::string name, std::string type, int scope, bool isArray, std::string ownerScope)
-    : Symbol(std::move(name), std::move(type), scope), isArray(isArray), ownerScope(std::move(ownerScope)) {}
+VariableSymbol::VariableSymbol(std::string name, std::string type, int scope, bool isArray, std::string ownerScope, int lineno)
+    : Symbol(std::move(name), std::move(type), scope, lineno), isArray(isArray), ownerScope(std::move(ownerScope)), slot(-1) {}
 
 // SymbolTable implementation
 SymbolTable::SymbolTable() : currentScope(0) {}
@@ -37,11 +38,12 @@ SymbolTable::~SymbolTable() {
 }
 
 void SymbolTable::addSymbol(Symbol* symbol) {
-    if (isDuplicateIdentifier(symbol->name, symbol->scope)) {
-        std::cerr << "Semantic Error: Duplicate identifier '" << symbol->name 
-                 << "' in scope " << symbol->scope << std::endl;
+    if (isDuplicateIdentifier(symbol->name, symbol->scope, symbol->getKind())) {
+        diagnostics.error(symbol->lineno, "duplicate-identifier",
+                          "Duplicate identifier '" + symbol->name + "' in scope " + std::to_string(symbol->scope));
     } else {
         table.push_back(symbol);
+        scopeIndex[symbol->scope].push_back(symbol);
     }
 }
 
@@ -55,8 +57,11 @@ bool SymbolTable::isSymbolInTable(const std::string& symbolName) const {
 }
 
 bool SymbolTable::isSymbolInScope(const std::string& symbolName, int scope) const {
-    for (const auto& symbol : table) {
-        if (symbol->name == symbolName && symbol->scope == scope) {
+    auto it = scopeIndex.find(scope);
+    if (it == scopeIndex.end()) return false;
+    
+    for (const auto& symbol : it->second) {
+        if (symbol->name == symbolName) {
             return true;
         }
     }
@@ -72,23 +77,25 @@ Symbol* SymbolTable::getSymbol(const std::string& symbolName) {
     return nullptr;
 }
 
+size_t SymbolTable::getSymbolCount() const {
+    return table.size();
+}
+
 std::vector<Symbol*> SymbolTable::getSymbolsByScope(int scope) const {
-    std::vector<Symbol*> result;
-    for (auto& symbol : table) {
-        if (symbol->scope == scope) {
-            result.push_back(symbol);
-        }
-    }
-    return result;
+    auto it = scopeIndex.find(scope);
+    if (it == scopeIndex.end()) return {};
+    return it->second;
 }
 
 void SymbolTable::enterScope() {
     currentScope++;
+    scopeStarts.push_back(table.size());
 }
 
 void SymbolTable::exitScope() {
     if (currentScope > 0) {
         currentScope--;
+        scopeStarts.pop_back();
     }
 }
 
@@ -96,6 +103,98 @@ int SymbolTable::getCurrentScope() const {
     return currentScope;
 }
 
+int FrameLayout::findSlot(const std::string& name) const {
+    auto it = slots.find(name);
+    return it == slots.end() ? -1 : it->second;
+}
+
+const FrameLayout& SymbolTable::assignFrameSlots(const Node* declaration, size_t firstSymbol) {
+    // Slot 0 holds 'this', parameters and locals follow in declaration order.
+    // A redeclared name was not added to the table, so it keeps its first slot.
+    FrameLayout& frame = frames[declaration];
+    frame = FrameLayout();
+    for (size_t i = firstSymbol; i < table.size(); ++i) {
+        if (table[i]->getKind() == "Variable") {
+            VariableSymbol* variable = static_cast<VariableSymbol*>(table[i]);
+            variable->slot = frame.size++;
+            frame.variables.push_back(variable);
+            frame.slots[variable->name] = variable->slot;
+            frame.references.push_back(isReferenceType(variable->type));
+        }
+    }
+    return frame;
+}
+
+const FrameLayout* SymbolTable::getFrame(const Node* declaration) const {
+    auto it = frames.find(declaration);
+    return it == frames.end() ? nullptr : &it->second;
+}
+
+VariableSymbol* SymbolTable::findVariable(const std::string& name, const Node* method, const std::string& className) const {
+    // Parameters and locals shadow fields
+    const FrameLayout* frame = method ? getFrame(method) : nullptr;
+    if (frame) {
+        int slot = frame->findSlot(name);
+        if (slot > 0) return frame->variables[slot - 1];
+    }
+
+    // Then the fields of the class, then those of each ancestor. Fields are the
+    // only variables without a slot, the walk is bounded in case of a cycle.
+    std::string owner = className;
+    for (size_t depth = 0; !owner.empty() && depth < table.size(); ++depth) {
+        std::string parent;
+        for (const auto& symbol : table) {
+            if (symbol->getKind() == "Variable") {
+                VariableSymbol* variable = static_cast<VariableSymbol*>(symbol);
+                if (variable->slot < 0 && variable->ownerScope == owner && variable->name == name) return variable;
+            } else if (symbol->getKind() == "Class" && symbol->name == owner) {
+                parent = static_cast<ClassSymbol*>(symbol)->parentClass;
+            }
+        }
+        owner = parent;
+    }
+    return nullptr;
+}
+
+bool SymbolTable::isClass(const std::string& name) const {
+    for (const auto& symbol : table) {
+        if (symbol->getKind() == "Class" && symbol->name == name) return true;
+    }
+    return false;
+}
+
+MethodSymbol* SymbolTable::findMethod(const std::string& name, const std::string& className) const {
+    std::string owner = className;
+    for (size_t depth = 0; !owner.empty() && depth < table.size(); ++depth) {
+        std::string parent;
+        for (const auto& symbol : table) {
+            if (symbol->getKind() == "Method") {
+                MethodSymbol* method = static_cast<MethodSymbol*>(symbol);
+                if (method->classOwner == owner && method->name == name) return method;
+            } else if (symbol->getKind() == "Class" && symbol->name == owner) {
+                parent = static_cast<ClassSymbol*>(symbol)->parentClass;
+            }
+        }
+        owner = parent;
+    }
+    return nullptr;
+}
+
+bool SymbolTable::lookupExpressionType(const Node* node, std::string& type) const {
+    auto it = expressionTypes.find(node);
+    if (it == expressionTypes.end()) return false;
+    type = it->second;
+    return true;
+}
+
+void SymbolTable::cacheExpressionType(const Node* node, const std::string& type) {
+    expressionTypes[node] = type;
+}
+
+Diagnostics& SymbolTable::getDiagnostics() {
+    return diagnostics;
+}
+
 void SymbolTable::printSymbols() const {
     std::cout << "\n===== SYMBOL TABLE =====\n";
     if (table.empty()) {
@@ -109,59 +208,208 @@ void SymbolTable::printSymbols() const {
     std::cout << "=======================\n\n";
 }
 
-void SymbolTable::generateDotFile(const std::string& filename) const {
+bool SymbolTable::generateDotFile(const std::string& filename) const {
     std::ofstream dotFile(filename);
     if (!dotFile.is_open()) {
         std::cerr << "Failed to open file: " << filename << std::endl;
-        return;
+        return false;
     }
 
     dotFile << "digraph SymbolTable {\n";
     dotFile << "  node [shape=record];\n";
 
-    // Group symbols by scope
-    std::unordered_map<int, std::vector<Symbol*>> scopeMap;
-    for (const auto& symbol : table) {
-        scopeMap[symbol->scope].push_back(symbol);
-    }
-
-    // Create nodes for each scope
-    for (const auto& pair : scopeMap) {
+    // Stream one cluster per scope straight from the scope index
+    int nodeId = 0;
+    for (const auto& pair : scopeIndex) {
         dotFile << "  subgraph cluster_" << pair.first << " {\n";
         dotFile << "    label=\"Scope " << pair.first << "\";\n";
         
         for (const auto& symbol : pair.second) {
-            std::string nodeId = symbol->getKind() + "_" + symbol->name + "_" + std::to_string(symbol->scope);
-            dotFile << "    " << nodeId << " [label=\"{" << symbol->getKind() << "|Name: " << symbol->name;
-            dotFile << "|Type: " << symbol->type << "}\"];\n";
+            dotFile << "    s" << nodeId++ << " [label=\"{" << symbol->getKind() << "|Name: " << symbol->name
+                    << "|Type: " << symbol->type << "}\"];\n";
         }
         
         dotFile << "  }\n";
     }
     
     dotFile << "}\n";
-    dotFile.close();
     std::cout << "Generated DOT file: " << filename << std::endl;
+    return true;
+}
+
+bool SymbolTable::generateJsonFile(const std::string& filename) const {
+    std::ofstream jsonFile(filename);
+    if (!jsonFile.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    // Identifiers and type names never contain characters that need escaping
+    jsonFile << "{\n  \"scopes\": [";
+    bool firstScope = true;
+    for (const auto& pair : scopeIndex) {
+        jsonFile << (firstScope ? "\n" : ",\n") << "    {\"scope\": " << pair.first << ", \"symbols\": [";
+        firstScope = false;
+        
+        bool firstSymbol = true;
+        for (const auto& symbol : pair.second) {
+            jsonFile << (firstSymbol ? "\n" : ",\n") << "      {\"kind\": \"" << symbol->getKind()
+                     << "\", \"name\": \"" << symbol->name << "\", \"type\": \"" << symbol->type << "\"";
+            if (symbol->getKind() == "Method") {
+                jsonFile << ", \"frameSize\": " << static_cast<MethodSymbol*>(symbol)->frameSize;
+            } else if (symbol->getKind() == "Variable" && static_cast<VariableSymbol*>(symbol)->slot >= 0) {
+                jsonFile << ", \"slot\": " << static_cast<VariableSymbol*>(symbol)->slot;
+            }
+            jsonFile << "}";
+            firstSymbol = false;
+        }
+        jsonFile << "\n    ]}";
+    }
+    jsonFile << "\n  ]\n}\n";
+    
+    std::cout << "Generated JSON file: " << filename << std::endl;
+    return true;
+}
+
+bool SymbolTable::buildClassHierarchy() {
+    bool result = true;
+    
+    classIds.clear();
+    classPre.clear();
+    classPost.clear();
+    
+    // Assign a dense id to every class
+    std::vector<ClassSymbol*> classes;
+    for (auto& symbol : table) {
+        if (symbol->getKind() == "Class") {
+            classIds[symbol->name] = classes.size();
+            classes.push_back(static_cast<ClassSymbol*>(symbol));
+        }
+    }
+    
+    int count = classes.size();
+    classPre.assign(count, -1);
+    classPost.assign(count, -1);
+    
+    // Resolve parents, -1 means the class is a root of the forest
+    std::vector<int> parent(count, -1);
+    for (int i = 0; i < count; ++i) {
+        const std::string& parentName = classes[i]->parentClass;
+        if (parentName.empty()) continue;
+        
+        auto it = classIds.find(parentName);
+        if (it == classIds.end()) {
+            diagnostics.error(classes[i]->lineno, "undefined-parent",
+                              "Class '" + classes[i]->name + "' extends undefined class '" + parentName + "'");
+            result = false;
+        } else {
+            parent[i] = it->second;
+        }
+    }
+    
+    // Detect inheritance cycles by walking each parent chain once (0 = new, 1 = on current walk, 2 = done)
+    std::vector<int> state(count, 0);
+    std::vector<bool> inCycle(count, false);
+    for (int i = 0; i < count; ++i) {
+        int current = i;
+        while (current != -1 && state[current] == 0) {
+            state[current] = 1;
+            current = parent[current];
+        }
+        
+        if (current != -1 && state[current] == 1) {
+            // Walked back onto this chain: everything from 'current' around the loop is a cycle
+            int member = current;
+            do {
+                inCycle[member] = true;
+                member = parent[member];
+            } while (member != current);
+            
+            diagnostics.error(classes[current]->lineno, "cyclic-inheritance",
+                              "Cyclic inheritance involving class '" + classes[current]->name + "'");
+            result = false;
+        }
+        
+        for (current = i; current != -1 && state[current] == 1; current = parent[current]) {
+            state[current] = 2;
+        }
+    }
+    
+    // Build child lists, classes on a cycle are left out of the forest
+    std::vector<std::vector<int>> children(count);
+    std::vector<int> roots;
+    for (int i = 0; i < count; ++i) {
+        if (inCycle[i]) continue;
+        if (parent[i] == -1) {
+            roots.push_back(i);
+        } else {
+            children[parent[i]].push_back(i);
+        }
+    }
+    
+    // Number the forest with an iterative DFS (pre-order on entry, post-order on exit)
+    int clock = 0;
+    std::vector<std::pair<int, size_t>> stack;
+    for (int root : roots) {
+        classPre[root] = clock++;
+        stack.emplace_back(root, 0);
+        
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            if (top.second < children[top.first].size()) {
+                int child = children[top.first][top.second++];
+                classPre[child] = clock++;
+                stack.emplace_back(child, 0);
+            } else {
+                classPost[top.first] = clock++;
+                stack.pop_back();
+            }
+        }
+    }
+    
+    return result;
+}
+
+bool SymbolTable::isSubtype(const std::string& subType, const std::string& superType) const {
+    if (subType == superType) return true;
+    
+    auto sub = classIds.find(subType);
+    auto super = classIds.find(superType);
+    if (sub == classIds.end() || super == classIds.end()) return false;
+    
+    int subId = sub->second;
+    int superId = super->second;
+    
+    // Classes outside the forest (cyclic or descending from a cycle) have no interval
+    if (classPre[subId] < 0 || classPre[superId] < 0) return false;
+    
+    // The subtype's interval must be nested inside the supertype's interval
+    return classPre[superId] <= classPre[subId] && classPost[subId] <= classPost[superId];
 }
 
 bool SymbolTable::checkTypes(const std::string& type1, const std::string& type2) const {
     // Basic type checking - equality check
     if (type1 == type2) return true;
     
-    // Handle array types
-    if (type1 == "int[]" && type2 == "int[]") return true;
-    
-    // TODO: Add more sophisticated type checking for class inheritance
-    
-    return false;
+    // A subclass instance can be used wherever its superclass is expected
+    return isSubtype(type2, type1);
 }
 
 bool SymbolTable::isUndeclaredIdentifier(const std::string& name) const {
     return !isSymbolInTable(name);
 }
 
-bool SymbolTable::isDuplicateIdentifier(const std::string& name, int scope) const {
-    return isSymbolInScope(name, scope);
+bool SymbolTable::isDuplicateIdentifier(const std::string& name, int scope, const std::string& kind) const {
+    // Only symbols declared since the enclosing class or method was entered can clash,
+    // so the same local in two methods or an overriding method is not a duplicate.
+    // Classes, methods and variables have separate namespaces, as in Java.
+    size_t start = scopeStarts.empty() ? 0 : scopeStarts.back();
+    for (size_t i = start; i < table.size(); ++i) {
+        if (table[i]->name == name && table[i]->scope == scope && table[i]->getKind() == kind) {
+            return true;
+        }
+    }
+    return false;
 }
 
 // Helper function to get the first child of a node if it exists
@@ -170,6 +418,34 @@ Node* getFirstChild(Node* node) {
     return node->children.front();
 }
 
+// Nodes whose children may include class headers, fields, method signatures or the
+// locals declared ahead of a method's statements. Method bodies are not entered.
+bool canContainDeclarations(Node* node) {
+    const std::string& type = node->type;
+    return type == "Goal" || type == "MainClass" || type == "ClassDeclarationList" ||
+           type == "VarDeclarationList" || type == "MethodDeclarationList" || type == "ParameterList";
+}
+
+// Adds the field or local declared by a VarDeclaration or ArrayDeclaration node
+void declareVariable(Node* node, SymbolTable& symbolTable, const std::string& ownerScope) {
+    std::string varType = node->children.empty() ? "" : node->children.front()->value;
+    bool isArray = (node->type == "ArrayDeclaration");
+    symbolTable.addSymbol(new VariableSymbol(node->value, varType, symbolTable.getCurrentScope(), isArray, ownerScope, node->lineno));
+}
+
+// Declares the locals a method body declares among its statements, in source order.
+// Only blocks, if and while can hold such a declaration, expressions are never entered.
+void declareStatementLocals(Node* node, SymbolTable& symbolTable, const std::string& ownerScope) {
+    const std::string& type = node->type;
+    if (type == "VarDeclaration" || type == "ArrayDeclaration") {
+        declareVariable(node, symbolTable, ownerScope);
+    } else if (type == "StatementList" || type == "IfStatement" || type == "WhileStatement") {
+        for (auto child : node->children) {
+            declareStatementLocals(child, symbolTable, ownerScope);
+        }
+    }
+}
+
 // AST traversal to build symbol table
 void buildSymbolTable(Node* node, SymbolTable& symbolTable, std::string currentClass, std::string currentMethod) {
     if (!node) return;
@@ -189,7 +465,7 @@ void buildSymbolTable(Node* node, SymbolTable& symbolTable, std::string currentC
         }
         
         // Add class to symbol table
-        symbolTable.addSymbol(new ClassSymbol(node->value, symbolTable.getCurrentScope(), parentClass));
+        symbolTable.addSymbol(new ClassSymbol(node->value, symbolTable.getCurrentScope(), parentClass, node->lineno));
         
         // Process class members with new scope
         symbolTable.enterScope();
@@ -210,8 +486,9 @@ void buildSymbolTable(Node* node, SymbolTable& symbolTable, std::string currentC
             returnType = typeNode->value;
         }
         
-        // Add method to symbol table
-        MethodSymbol* methodSymbol = new MethodSymbol(node->value, returnType, symbolTable.getCurrentScope(), currentClass);
+        // Add method to symbol table, at the line of its header (the return type) rather than its closing brace
+        int headerLine = node->children.empty() ? node->lineno : node->children.front()->lineno;
+        MethodSymbol* methodSymbol = new MethodSymbol(node->value, returnType, symbolTable.getCurrentScope(), currentClass, headerLine);
         
         // Process parameters
         for (auto child : node->children) {
@@ -231,26 +508,35 @@ void buildSymbolTable(Node* node, SymbolTable& symbolTable, std::string currentC
         symbolTable.addSymbol(methodSymbol);
         
         // Process method body with new scope
+        size_t firstLocal = symbolTable.getSymbolCount();
         symbolTable.enterScope();
         for (auto child : node->children) {
-            buildSymbolTable(child, symbolTable, currentClass, currentMethod);
+            if (child->type == "StatementList") {
+                declareStatementLocals(child, symbolTable, currentMethod);
+            } else {
+                buildSymbolTable(child, symbolTable, currentClass, currentMethod);
+            }
         }
         symbolTable.exitScope();
+        
+        // Lay out the method's frame from the parameters and locals just declared
+        methodSymbol->frameSize = symbolTable.assignFrameSlots(node, firstLocal).size;
         return;
     }
-    else if (node->type == "VarDeclaration" || node->type == "ArrayDeclaration") {
-        // Process variable declarations
-        std::string varType = "";
-        bool isArray = (node->type == "ArrayDeclaration");
-        
-        // Get variable type
-        if (!node->children.empty()) {
-            varType = node->children.front()->value;
+    else if (node->type == "MainMethod") {
+        // main has no symbol of its own, but its locals get a frame like any method
+        size_t firstLocal = symbolTable.getSymbolCount();
+        symbolTable.enterScope();
+        for (auto child : node->children) {
+            declareStatementLocals(child, symbolTable, "main");
         }
-        
-        // Add variable to symbol table
-        std::string ownerScope = currentMethod.empty() ? currentClass : currentMethod;
-        symbolTable.addSymbol(new VariableSymbol(node->value, varType, symbolTable.getCurrentScope(), isArray, ownerScope));
+        symbolTable.exitScope();
+        symbolTable.assignFrameSlots(node, firstLocal);
+        return;
+    }
+    else if (node->type == "VarDeclaration" || node->type == "ArrayDeclaration") {
+        // A field, or a local declared ahead of the method's statements
+        declareVariable(node, symbolTable, currentMethod.empty() ? currentClass : currentMethod);
     }
     else if (node->type == "Parameter") {
         // Process parameters as variables
@@ -262,18 +548,45 @@ void buildSymbolTable(Node* node, SymbolTable& symbolTable, std::string currentC
         }
         
         // Add parameter to symbol table
-        symbolTable.addSymbol(new VariableSymbol(node->value, paramType, symbolTable.getCurrentScope(), false, currentMethod));
+        symbolTable.addSymbol(new VariableSymbol(node->value, paramType, symbolTable.getCurrentScope(), false, currentMethod, node->lineno));
     }
     
-    // Continue traversal for all children
+    // Continue traversal only through nodes that can hold declarations.
+    // Expressions and simple statements never declare anything, so their subtrees are skipped.
+    if (!canContainDeclarations(node)) return;
     for (auto child : node->children) {
         buildSymbolTable(child, symbolTable, currentClass, currentMethod);
     }
 }
 
-// Helper function to get the type of an expression node
-std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
-    if (!node) return "error";
+// Variable a name refers to inside currentMethod of currentClass. Names that are
+// not in scope there fall back to the first symbol with that name, as before.
+Symbol* lookupVariable(const std::string& name, SymbolTable& symbolTable, const std::string& currentClass,
+                       const Node* currentMethod) {
+    Symbol* variable = symbolTable.findVariable(name, currentMethod, currentClass);
+    return variable ? variable : symbolTable.getSymbol(name);
+}
+
+// Method a call resolves to: looked up in the receiver's class when the receiver
+// has a class type, otherwise the first symbol with that name, as before
+Symbol* lookupMethod(Node* call, SymbolTable& symbolTable, const std::string& currentClass, const Node* currentMethod) {
+    if (!call->children.empty()) {
+        std::string receiverType = getExpressionType(call->children.front(), symbolTable, currentClass, currentMethod);
+        if (symbolTable.isClass(receiverType)) return symbolTable.findMethod(call->value, receiverType);
+    }
+    return symbolTable.getSymbol(call->value);
+}
+
+// Locals declared among the statements are only in scope from their declaration on
+bool isUsedBeforeDeclaration(Symbol* symbol, Node* use) {
+    if (!symbol || symbol->getKind() != "Variable") return false;
+    VariableSymbol* variable = static_cast<VariableSymbol*>(symbol);
+    return variable->slot > 0 && variable->lineno > use->lineno;
+}
+
+// Helper function to get the type of an expression node, see getExpressionType
+std::string computeExpressionType(Node* node, SymbolTable& symbolTable, const std::string& currentClass,
+                                  const Node* currentMethod) {
     
     if (node->type == "Int") {
         return "int";
@@ -283,7 +596,7 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
     } 
     else if (node->type == "Identifier") {
         // Look up identifier type in symbol table
-        Symbol* symbol = symbolTable.getSymbol(node->value);
+        Symbol* symbol = lookupVariable(node->value, symbolTable, currentClass, currentMethod);
         if (symbol) {
             return symbol->type;
         } else {
@@ -291,10 +604,8 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
         }
     } 
     else if (node->type == "This") {
-        // 'this' refers to the current class
-        // We need to know the current class context to determine its type
-        // For now, return a placeholder
-        return "this";
+        // 'this' has the type of the class the expression appears in
+        return currentClass.empty() ? "error" : currentClass;
     }
     else if (node->type == "NewObject") {
         // New object type is the class name
@@ -306,7 +617,7 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
     else if (node->type == "ArrayAccess") {
         // Array access returns the element type
         if (node->children.empty()) return "error";
-        std::string arrayType = getExpressionType(node->children.front(), symbolTable);
+        std::string arrayType = getExpressionType(node->children.front(), symbolTable, currentClass, currentMethod);
         if (arrayType == "int[]") {
             return "int";
         }
@@ -319,7 +630,7 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
     else if (node->type == "MethodCall") {
         // Need to look up method return type
         // This is simplified - would need to resolve the class and method
-        Symbol* methodSymbol = symbolTable.getSymbol(node->value);
+        Symbol* methodSymbol = lookupMethod(node, symbolTable, currentClass, currentMethod);
         if (methodSymbol && methodSymbol->getKind() == "Method") {
             MethodSymbol* method = static_cast<MethodSymbol*>(methodSymbol);
             return method->returnType;
@@ -332,9 +643,9 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
         if (node->children.size() < 2) return "error";
         
         auto it = node->children.begin();
-        std::string leftType = getExpressionType(*it, symbolTable);
+        std::string leftType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
         ++it;
-        std::string rightType = getExpressionType(*it, symbolTable);
+        std::string rightType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
         
         if (leftType == "int" && rightType == "int") {
             return "int";
@@ -346,9 +657,9 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
         if (node->children.size() < 2) return "error";
         
         auto it = node->children.begin();
-        std::string leftType = getExpressionType(*it, symbolTable);
+        std::string leftType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
         ++it;
-        std::string rightType = getExpressionType(*it, symbolTable);
+        std::string rightType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
         
         if (leftType == "boolean" && rightType == "boolean") {
             return "boolean";
@@ -360,9 +671,9 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
         if (node->children.size() < 2) return "error";
         
         auto it = node->children.begin();
-        std::string leftType = getExpressionType(*it, symbolTable);
+        std::string leftType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
         ++it;
-        std::string rightType = getExpressionType(*it, symbolTable);
+        std::string rightType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
         
         if (leftType == rightType && (leftType == "int" || leftType == "boolean")) {
             return "boolean";
@@ -373,7 +684,7 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
         // Not operation should be on boolean and return boolean
         if (node->children.empty()) return "error";
         
-        std::string exprType = getExpressionType(node->children.front(), symbolTable);
+        std::string exprType = getExpressionType(node->children.front(), symbolTable, currentClass, currentMethod);
         if (exprType == "boolean") {
             return "boolean";
         }
@@ -384,18 +695,48 @@ std::string getExpressionType(Node* node, SymbolTable& symbolTable) {
     return "unknown";
 }
 
+// Expression types are memoized per node: statement checks and the recursive
+// walk over their operands ask for the same subexpressions again
+std::string getExpressionType(Node* node, SymbolTable& symbolTable, const std::string& currentClass,
+                              const Node* currentMethod) {
+    if (!node) return "error";
+    
+    std::string type;
+    if (!symbolTable.lookupExpressionType(node, type)) {
+        type = computeExpressionType(node, symbolTable, currentClass, currentMethod);
+        symbolTable.cacheExpressionType(node, type);
+    }
+    return type;
+}
+
 // Enhanced semantic analysis implementation
-bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
+bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable, std::string currentClass,
+                             const Node* currentMethod) {
     if (!node) return true;
     
+    Diagnostics& diagnostics = symbolTable.getDiagnostics();
+    
+    // Stop walking once the error limit has been reached
+    if (diagnostics.limitReached()) return false;
+    
     bool result = true;
     
+    // Names inside a method, its return expression included, resolve through that method's frame first
+    if (node->type == "MethodDeclaration" || node->type == "MainMethod") {
+        currentMethod = node;
+    }
+    
     // Check for semantic errors based on node type
     if (node->type == "Identifier") {
         // Check if identifier is declared
         if (symbolTable.isUndeclaredIdentifier(node->value)) {
-            std::cerr << "Semantic Error at line " << node->lineno 
-                     << ": Undeclared identifier '" << node->value << "'" << std::endl;
+            diagnostics.error(node->lineno, "undeclared-identifier",
+                              "Undeclared identifier '" + node->value + "'");
+            result = false;
+        }
+        else if (isUsedBeforeDeclaration(lookupVariable(node->value, symbolTable, currentClass, currentMethod), node)) {
+            diagnostics.error(node->lineno, "undeclared-identifier",
+                              "Identifier '" + node->value + "' used before its declaration");
             result = false;
         }
     } 
@@ -403,20 +744,24 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
         // Check variable assignment
         // 1. Check if variable is declared
         if (symbolTable.isUndeclaredIdentifier(node->value)) {
-            std::cerr << "Semantic Error at line " << node->lineno 
-                     << ": Assignment to undeclared variable '" << node->value << "'" << std::endl;
+            diagnostics.error(node->lineno, "undeclared-identifier",
+                              "Assignment to undeclared variable '" + node->value + "'");
+            result = false;
+        }
+        else if (isUsedBeforeDeclaration(lookupVariable(node->value, symbolTable, currentClass, currentMethod), node)) {
+            diagnostics.error(node->lineno, "undeclared-identifier",
+                              "Assignment to variable '" + node->value + "' before its declaration");
             result = false;
         }
         // 2. Type check: left-hand side and right-hand side must have compatible types
         else if (!node->children.empty()) {
-            Symbol* varSymbol = symbolTable.getSymbol(node->value);
+            Symbol* varSymbol = lookupVariable(node->value, symbolTable, currentClass, currentMethod);
             std::string lhsType = varSymbol ? varSymbol->type : "error";
-            std::string rhsType = getExpressionType(node->children.front(), symbolTable);
+            std::string rhsType = getExpressionType(node->children.front(), symbolTable, currentClass, currentMethod);
             
             if (!symbolTable.checkTypes(lhsType, rhsType)) {
-                std::cerr << "Semantic Error at line " << node->lineno 
-                         << ": Type mismatch in assignment to '" << node->value 
-                         << "'. Expected '" << lhsType << "', got '" << rhsType << "'" << std::endl;
+                diagnostics.error(node->lineno, "type-mismatch",
+                                  "Type mismatch in assignment to '" + node->value + "'. Expected '" + lhsType + "', got '" + rhsType + "'");
                 result = false;
             }
         }
@@ -425,36 +770,36 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
         // Check array assignment
         // 1. Check if array variable is declared
         if (symbolTable.isUndeclaredIdentifier(node->value)) {
-            std::cerr << "Semantic Error at line " << node->lineno 
-                     << ": Assignment to undeclared array '" << node->value << "'" << std::endl;
+            diagnostics.error(node->lineno, "undeclared-identifier",
+                              "Assignment to undeclared array '" + node->value + "'");
             result = false;
         }
         else {
             // 2. Check if it's actually an array type
-            Symbol* arraySymbol = symbolTable.getSymbol(node->value);
+            Symbol* arraySymbol = lookupVariable(node->value, symbolTable, currentClass, currentMethod);
             if (arraySymbol && arraySymbol->type != "int[]") {
-                std::cerr << "Semantic Error at line " << node->lineno 
-                         << ": Type '" << arraySymbol->type << "' is not an array type" << std::endl;
+                diagnostics.error(node->lineno, "not-an-array",
+                                  "Type '" + arraySymbol->type + "' is not an array type");
                 result = false;
             }
             
             // 3. Check if index is an integer
             if (!node->children.empty()) {
                 auto it = node->children.begin();
-                std::string indexType = getExpressionType(*it, symbolTable);
+                std::string indexType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
                 if (indexType != "int") {
-                    std::cerr << "Semantic Error at line " << node->lineno 
-                             << ": Array index must be an integer, got '" << indexType << "'" << std::endl;
+                    diagnostics.error(node->lineno, "array-index-type",
+                                      "Array index must be an integer, got '" + indexType + "'");
                     result = false;
                 }
                 
                 // 4. Check if the value assigned is compatible with the array element type
                 ++it;
                 if (it != node->children.end()) {
-                    std::string valueType = getExpressionType(*it, symbolTable);
+                    std::string valueType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
                     if (valueType != "int") {
-                        std::cerr << "Semantic Error at line " << node->lineno 
-                                 << ": Cannot assign '" << valueType << "' to element of int array" << std::endl;
+                        diagnostics.error(node->lineno, "array-element-type",
+                                          "Cannot assign '" + valueType + "' to element of int array");
                         result = false;
                     }
                 }
@@ -464,10 +809,10 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
     else if (node->type == "IfStatement" || node->type == "WhileStatement") {
         // Check if condition is a boolean expression
         if (!node->children.empty()) {
-            std::string conditionType = getExpressionType(node->children.front(), symbolTable);
+            std::string conditionType = getExpressionType(node->children.front(), symbolTable, currentClass, currentMethod);
             if (conditionType != "boolean") {
-                std::cerr << "Semantic Error at line " << node->lineno 
-                         << ": Condition must be of type boolean, got '" << conditionType << "'" << std::endl;
+                diagnostics.error(node->lineno, "condition-type",
+                                  "Condition must be of type boolean, got '" + conditionType + "'");
                 result = false;
             }
         }
@@ -475,10 +820,10 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
     else if (node->type == "PrintStatement") {
         // Check if print statement argument is an integer
         if (!node->children.empty()) {
-            std::string exprType = getExpressionType(node->children.front(), symbolTable);
+            std::string exprType = getExpressionType(node->children.front(), symbolTable, currentClass, currentMethod);
             if (exprType != "int") {
-                std::cerr << "Semantic Error at line " << node->lineno 
-                         << ": Print statement requires integer expression, got '" << exprType << "'" << std::endl;
+                diagnostics.error(node->lineno, "print-type",
+                                  "Print statement requires integer expression, got '" + exprType + "'");
                 result = false;
             }
         }
@@ -486,10 +831,9 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
     else if (node->type == "MethodCall") {
         // Check method call
         // 1. Check if method exists
-        Symbol* symbol = symbolTable.getSymbol(node->value);
+        Symbol* symbol = lookupMethod(node, symbolTable, currentClass, currentMethod);
         if (!symbol || symbol->getKind() != "Method") {
-            std::cerr << "Semantic Error at line " << node->lineno 
-                     << ": Undefined method '" << node->value << "'" << std::endl;
+            diagnostics.error(node->lineno, "undefined-method", "Undefined method '" + node->value + "'");
             result = false;
         }
         else {
@@ -510,9 +854,8 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
                 int paramCount = method->parameters.size();
                 
                 if (argCount != paramCount) {
-                    std::cerr << "Semantic Error at line " << node->lineno 
-                             << ": Method '" << node->value << "' expects " << paramCount 
-                             << " parameters but got " << argCount << std::endl;
+                    diagnostics.error(node->lineno, "argument-count",
+                                      "Method '" + node->value + "' expects " + std::to_string(paramCount) + " parameters but got " + std::to_string(argCount));
                     result = false;
                 }
                 else {
@@ -521,14 +864,12 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
                     auto paramIt = method->parameters.begin();
                     
                     for (int i = 0; i < argCount; ++i, ++argIt, ++paramIt) {
-                        std::string argType = getExpressionType(*argIt, symbolTable);
+                        std::string argType = getExpressionType(*argIt, symbolTable, currentClass, currentMethod);
                         std::string paramType = paramIt->second; // second is the type
                         
                         if (!symbolTable.checkTypes(paramType, argType)) {
-                            std::cerr << "Semantic Error at line " << node->lineno 
-                                     << ": Parameter type mismatch in call to '" << node->value 
-                                     << "'. Parameter " << (i+1) << " expects '" << paramType 
-                                     << "', got '" << argType << "'" << std::endl;
+                            diagnostics.error(node->lineno, "argument-type",
+                                              "Parameter type mismatch in call to '" + node->value + "'. Parameter " + std::to_string(i + 1) + " expects '" + paramType + "', got '" + argType + "'");
                             result = false;
                         }
                     }
@@ -536,32 +877,38 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
             }
         }
     }
-    else if (node->type == "Return") {
-        // Check if return type matches method return type
-        // This requires knowing which method we're in - would need method context
-        // For simplicity, this check is limited
-        if (!node->children.empty()) {
-            std::string returnType = getExpressionType(node->children.front(), symbolTable);
-            // We would need to check against the method's declared return type
-            // This would require passing method context through the traversal
+    else if (node->type == "MethodDeclaration") {
+        // Check if the returned expression matches the declared return type
+        // The Return node is the last child, the declared type is the first
+        if (node->children.size() >= 2 && node->children.back()->type == "Return" &&
+            !node->children.back()->children.empty()) {
+            std::string declaredType = node->children.front()->value;
+            std::string returnType = getExpressionType(node->children.back()->children.front(), symbolTable, currentClass, currentMethod);
+
+            
+            if (!symbolTable.checkTypes(declaredType, returnType)) {
+                diagnostics.error(node->children.front()->lineno, "return-type",
+                                  "Method '" + node->value + "' must return '" + declaredType + "', got '" + returnType + "'");
+                result = false;
+            }
         }
     }
     else if (node->type == "ArrayAccess") {
         // Check if array index is an integer
         if (node->children.size() >= 2) {
             auto it = node->children.begin();
-            std::string arrayType = getExpressionType(*it, symbolTable);
+            std::string arrayType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
             if (arrayType != "int[]") {
-                std::cerr << "Semantic Error at line " << node->lineno 
-                         << ": Array access requires array type, got '" << arrayType << "'" << std::endl;
+                diagnostics.error(node->lineno, "not-an-array",
+                                  "Array access requires array type, got '" + arrayType + "'");
                 result = false;
             }
             
             ++it;
-            std::string indexType = getExpressionType(*it, symbolTable);
+            std::string indexType = getExpressionType(*it, symbolTable, currentClass, currentMethod);
             if (indexType != "int") {
-                std::cerr << "Semantic Error at line " << node->lineno 
-                         << ": Array index must be an integer, got '" << indexType << "'" << std::endl;
+                diagnostics.error(node->lineno, "array-index-type",
+                                  "Array index must be an integer, got '" + indexType + "'");
                 result = false;
             }
         }
@@ -569,18 +916,23 @@ bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable) {
     else if (node->type == "Length") {
         // Check if length operation is applied to an array
         if (!node->children.empty()) {
-            std::string exprType = getExpressionType(node->children.front(), symbolTable);
+            std::string exprType = getExpressionType(node->children.front(), symbolTable, currentClass, currentMethod);
             if (exprType != "int[]") {
-                std::cerr << "Semantic Error at line " << node->lineno 
-                         << ": Length operator requires array type, got '" << exprType << "'" << std::endl;
+                diagnostics.error(node->lineno, "not-an-array",
+                                  "Length operator requires array type, got '" + exprType + "'");
                 result = false;
             }
         }
     }
     
+    // Expressions inside a class declaration are checked in that class's context
+    if (node->type == "ClassDeclaration") {
+        currentClass = node->value;
+    }
+    
     // Recursively check all children
     for (auto child : node->children) {
-        result = performSemanticAnalysis(child, symbolTable) && result;
+        result = performSemanticAnalysis(child, symbolTable, currentClass, currentMethod) && result;
     }
     
     return result;
@@ -5,8 +5,10 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <memory>
 #include "Node.h"
+#include "diagnostics.h"
 
 // Forward declarations
 class Symbol;
@@ -21,8 +23,9 @@ public:
     std::string name;
     std::string type;
     int scope;
+    int lineno;
     
-    Symbol(std::string name, std::string type, int scope);
+    Symbol(std::string name, std::string type, int scope, int lineno = 0);
     virtual ~Symbol() = default;
     virtual void printSymbol() const;
     virtual std::string getKind() const { return "Symbol"; }
@@ -33,7 +36,7 @@ class ClassSymbol : public Symbol {
 public:
     std::string parentClass; // For inheritance
     
-    ClassSymbol(std::string name, int scope, std::string parentClass = "");
+    ClassSymbol(std::string name, int scope, std::string parentClass = "", int lineno = 0);
     std::string getKind() const override { return "Class"; }
 };
 
@@ -43,8 +46,9 @@ public:
     std::string returnType;
     std::vector<std::pair<std::string, std::string>> parameters; // (name, type) pairs
     std::string classOwner;
+    int frameSize; // Frame slots: 'this', then parameters, then locals
     
-    MethodSymbol(std::string name, std::string returnType, int scope, std::string classOwner);
+    MethodSymbol(std::string name, std::string returnType, int scope, std::string classOwner, int lineno = 0);
     void addParameter(std::string name, std::string type);
     std::string getKind() const override { return "Method"; }
 };
@@ -54,17 +58,51 @@ class VariableSymbol : public Symbol {
 public:
     bool isArray;
     std::string ownerScope; // Class name or method name
+    int slot; // Index in the method's frame, -1 for fields
     
-    VariableSymbol(std::string name, std::string type, int scope, bool isArray, std::string ownerScope);
+    VariableSymbol(std::string name, std::string type, int scope, bool isArray, std::string ownerScope, int lineno = 0);
     std::string getKind() const override { return "Variable"; }
 };
 
+// Frame of a method, shared by the evaluator and the code generator. Slot 0
+// holds 'this', parameters and locals follow in declaration order.
+struct FrameLayout {
+    int size = 1;
+    std::vector<VariableSymbol*> variables;          // The variable in slot i + 1
+    std::unordered_map<std::string, int> slots;      // Slot of each parameter and local by name
+    std::vector<bool> references{true};              // Slots declared with a class or array type, 'this' included
+    
+    // Slot of a parameter or local, -1 if the name is not declared in the method
+    int findSlot(const std::string& name) const;
+};
+
 // Symbol Table class
 class SymbolTable {
 private:
     std::vector<Symbol*> table;
     int currentScope;
     
+    // Symbols grouped by scope level, in declaration order (maintained by addSymbol)
+    std::map<int, std::vector<Symbol*>> scopeIndex;
+    
+    // Position in 'table' where each open class or method scope begins
+    std::vector<size_t> scopeStarts;
+    
+    // Class hierarchy index: every class gets a pre/post-order interval in the
+    // inheritance forest so that subtype checks are a pair of integer compares.
+    std::unordered_map<std::string, int> classIds;
+    std::vector<int> classPre;
+    std::vector<int> classPost;
+    
+    // Semantic errors found while building and checking the table
+    Diagnostics diagnostics;
+    
+    // Memoized results of getExpressionType, valid once the table is complete
+    std::unordered_map<const Node*, std::string> expressionTypes;
+    
+    // Frame of every method (and of main), by declaration node
+    std::unordered_map<const Node*, FrameLayout> frames;
+    
 public:
     SymbolTable();
     ~SymbolTable();
@@ -73,25 +111,52 @@ public:
     bool isSymbolInTable(const std::string& symbolName) const;
     bool isSymbolInScope(const std::string& symbolName, int scope) const;
     Symbol* getSymbol(const std::string& symbolName);
+    size_t getSymbolCount() const;
     std::vector<Symbol*> getSymbolsByScope(int scope) const;
     
     void enterScope();
     void exitScope();
     int getCurrentScope() const;
+    const FrameLayout& assignFrameSlots(const Node* declaration, size_t firstSymbol);
+    const FrameLayout* getFrame(const Node* declaration) const;
+    
+    // Parameter or local of 'method', else a field of 'className' or one of its
+    // ancestors, nullptr if the name is neither
+    VariableSymbol* findVariable(const std::string& name, const Node* method, const std::string& className) const;
+    
+    bool isClass(const std::string& name) const;
+    
+    // Method of 'className' or the nearest ancestor that declares it, nullptr if there is none
+    MethodSymbol* findMethod(const std::string& name, const std::string& className) const;
+    
+    Diagnostics& getDiagnostics();
     
     void printSymbols() const;
-    void generateDotFile(const std::string& filename) const;
+    bool generateDotFile(const std::string& filename) const;
+    bool generateJsonFile(const std::string& filename) const;
+    
+    // Class hierarchy (call once after buildSymbolTable)
+    bool buildClassHierarchy();
+    bool isSubtype(const std::string& subType, const std::string& superType) const;
     
     // Semantic analysis helpers
     bool checkTypes(const std::string& type1, const std::string& type2) const;
     bool isUndeclaredIdentifier(const std::string& name) const;
-    bool isDuplicateIdentifier(const std::string& name, int scope) const;
+    bool isDuplicateIdentifier(const std::string& name, int scope, const std::string& kind) const;
+    bool lookupExpressionType(const Node* node, std::string& type) const;
+    void cacheExpressionType(const Node* node, const std::string& type);
 };
 
 // AST traversal function to build symbol table
 void buildSymbolTable(Node* node, SymbolTable& symbolTable, std::string currentClass = "", std::string currentMethod = "");
 
+// Static type of an expression node ("error" if it cannot be typed), 'this' is typed as currentClass
+// and names resolve through the frame of currentMethod (a MethodDeclaration or MainMethod node)
+std::string getExpressionType(Node* node, SymbolTable& symbolTable, const std::string& currentClass = "",
+                              const Node* currentMethod = nullptr);
+
 // Semantic analysis function
-bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable);
+bool performSemanticAnalysis(Node* node, SymbolTable& symbolTable, std::string currentClass = "",
+                             const Node* currentMethod = nullptr);
 
 #endif // SYMBOLTABLE_H
\ No newline at end of file
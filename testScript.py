@@ -4,6 +4,9 @@ import re
 import subprocess
 import sys
 import filecmp
+import random
+import tempfile
+import time
 
 # Global file ID counter
 global_file_id = 1
@@ -19,8 +22,8 @@ class Colors:
 def colored(text, color):
     return f"{color}{text}{Colors.END}"
 
-def run_compiler(file_path):
-    process = subprocess.Popen(['./compiler', file_path], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+def run_compiler(file_path, flags=()):
+    process = subprocess.Popen(['./compiler', file_path] + list(flags), stdout=subprocess.PIPE, stderr=subprocess.PIPE)
     stdout, stderr = process.communicate()
     return stdout.decode(), stderr.decode()
 
@@ -78,13 +81,13 @@ def display_summary(file_details):
             success = expected_lines == compiler_error_lines
             print_test_summary(file_id, details['file_name'], success)
 
-def run_test_files(folder_path, test_type, file_details, global_id):
+def run_test_files(folder_path, test_type, file_details, global_id, flags=()):
     print(colored(f"\nRunning {test_type} test classes...", Colors.GREEN))
     for file in os.listdir(folder_path):
         if file.endswith('.java'):
             file_path = os.path.join(folder_path, file)
             expected_errors = extract_expected_errors(file_path)
-            stdout, stderr = run_compiler(file_path)
+            stdout, stderr = run_compiler(file_path, flags)
             compiler_errors = parse_compiler_errors(stderr)
 
             # Check if all expected errors match the compiler-reported errors
@@ -198,6 +201,271 @@ def run_interpreter_tests(folder_path, test_type, file_details, global_id):
 
     return global_id
 
+def run_timed(command):
+    start = time.perf_counter()
+    process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    return process.stdout.decode(), process.stderr.decode(), time.perf_counter() - start
+
+# Optimization passes the differential tests check, each against the unoptimized evaluator
+OPTIMIZATION_LEVELS = [[], ['-inline']]
+
+def run_differential_tests(folder_path, test_type, file_details, global_id):
+    # The AST evaluator (-run) on the unoptimized tree is the oracle. At every optimization
+    # level both the evaluator and the native build of -emit-asm are checked against it.
+    print(colored(f"\nRunning {test_type} test classes...", Colors.GREEN))
+    for file in sorted(os.listdir(folder_path)):
+        if file.endswith('.java'):
+            file_path = os.path.join(folder_path, file)
+
+            # Both sides of the speedup are timed as whole processes, so each includes its
+            # startup and the evaluator's also includes parsing the program
+            stdout, stderr, evaluation_time = run_timed(['./compiler', file_path, '-run'])
+            if 'Program output:\n' not in stdout:
+                continue
+            expected = stdout.split('Program output:\n', 1)[1]
+
+            success = True
+            outputs = ''
+            speedups = []
+            for flags in OPTIMIZATION_LEVELS:
+                level = ' '.join(flags) or 'no flags'
+                level_stdout, level_stderr, _ = run_timed(['./compiler', file_path, '-run', '-emit-asm'] + flags)
+                if 'Program output:\n' not in level_stdout:
+                    # -inline needs a program that passes -semantic
+                    speedups.append(f"{level}: skipped")
+                    continue
+                evaluated = level_stdout.split('Program output:\n', 1)[1]
+
+                native_output = ''
+                native_time = 0
+                if os.path.exists('output.s'):
+                    subprocess.run(['gcc', '-O2', '-o', 'program', 'output.s', 'runtime.c'])
+                    native_output, native_errors, native_time = run_timed(['./program'])
+                    os.remove('output.s')
+
+                success = success and evaluated == expected and native_output == expected
+                outputs += f"[{level}]\n{native_output}"
+                speedup = evaluation_time / native_time if native_time > 0 else 0
+                speedups.append(f"{level}: {speedup:.1f}x")
+
+            file_details[global_id] = {
+                'file_name': file,
+                'test_type': test_type,
+                'stdout': outputs,
+                'stderr': stderr,
+                'expected': expected,
+            }
+            print_test_summary(global_id, file, success)
+            print(f"        native back end vs the AST evaluator ({', '.join(speedups)})")
+            global_id += 1
+
+    return global_id
+
+def generate_random_program(rng, name, prefix='Fuzz'):
+    # Random but always terminating MiniJava: bounded loops, int arithmetic, arrays and calls,
+    # and objects of a small class hierarchy called through fields, locals and parameters.
+    # Every class name starts with 'prefix'. No receiver is ever null: 'c1' and 'c2' link to
+    # each other and only they are asked for their next cell.
+    cell, doubler, negator = f'{prefix}Cell', f'{prefix}Doubler', f'{prefix}Negator'
+
+    def receiver():
+        return rng.choice(['c1', 'c2', 'o', 'c1.Next()', 'c2.Next()'])
+
+    def expression(depth):
+        if depth == 0 or rng.random() < 0.3:
+            return rng.choice(['x', 'y', 'n1', str(rng.randint(0, 100)), 'arr[' + str(rng.randint(0, 9)) + ']', 'arr.length', f'{receiver()}.Get()'])
+        op = rng.choice(['+', '-', '*'])
+        call = rng.random()
+        if call < 0.1:
+            return f'this.Helper({expression(depth - 1)}, {expression(depth - 1)})'
+        if call < 0.2:
+            return f'{receiver()}.Set({expression(depth - 1)})'
+        if call < 0.25:
+            return f'this.Total({receiver()}, {receiver()})'
+        return f'({expression(depth - 1)} {op} {expression(depth - 1)})'
+
+    def condition(depth):
+        kind = rng.choice(['<', '==', '&&', '!'])
+        if kind == '&&':
+            return f'({condition(depth - 1) if depth else "true"} && {expression(1)} < {expression(1)})'
+        if kind == '!':
+            return f'!({expression(1)} < {expression(1)})'
+        return f'({expression(depth)} {kind} {expression(depth)})'
+
+    def statements(depth, count):
+        lines = []
+        for _ in range(count):
+            kind = rng.choice(['assign', 'assign', 'print', 'array', 'object', 'if', 'while'] if depth else ['assign', 'print', 'array', 'object'])
+            if kind == 'assign':
+                lines.append(f'{rng.choice(["x", "y"])} = {expression(3)};')
+            elif kind == 'print':
+                lines.append(f'System.out.println({expression(3)});')
+            elif kind == 'array':
+                lines.append(f'arr[{rng.randint(0, 9)}] = {expression(2)};')
+            elif kind == 'object':
+                # Rebinding 'o' or swapping the linked cells changes which override runs
+                lines.append(rng.choice([f'o = new {rng.choice([cell, doubler, negator])}(); y = o.Set({expression(2)});',
+                                         'o = c1; c1 = c2; c2 = o;', f'o = {receiver()};']))
+            elif kind == 'if':
+                lines.append(f'if ({condition(2)}) {{ {" ".join(statements(depth - 1, 2))} }} else {{ {" ".join(statements(depth - 1, 2))} }}')
+            else:
+                # Each nesting depth has its own counter so inner loops cannot reset outer ones
+                counter = f'n{depth}'
+                lines.append(f'{counter} = 0; while ({counter} < {rng.randint(1, 10)}) {{ {" ".join(statements(depth - 1, 2))} {counter} = {counter} + 1; }}')
+        return lines
+
+    return f"""public class {name} {{
+    public static void main(String[] a) {{
+        System.out.println(new {prefix}().Run({rng.randint(0, 50)}));
+    }}
+}}
+
+class {prefix} {{
+    int[] arr;
+    {cell} c1;
+    {cell} c2;
+
+    public int Helper(int x, int y) {{
+        return x * 3 - y;
+    }}
+
+    public int Total({cell} a, {cell} b) {{
+        return a.Get() - b.Get();
+    }}
+
+    public int Run(int x) {{
+        int y;
+        int n1;
+        int n2;
+        int n3;
+        {cell} o;
+        arr = new int[10];
+        c1 = new {rng.choice([cell, doubler, negator])}();
+        c2 = new {rng.choice([cell, doubler, negator])}();
+        y = c1.Link(c2) + c2.Link(c1);
+        o = c1;
+        y = {rng.randint(0, 50)};
+        n1 = 0;
+        {chr(10).join('        ' + line for line in statements(3, 8)).strip()}
+        return x + y;
+    }}
+}}
+
+class {cell} {{
+    int value;
+    {cell} next;
+
+    public int Set(int v) {{
+        value = v;
+        return this.Get();
+    }}
+
+    public int Get() {{
+        return value;
+    }}
+
+    public int Link({cell} n) {{
+        next = n;
+        return 0;
+    }}
+
+    public {cell} Next() {{
+        return next;
+    }}
+}}
+
+class {doubler} extends {cell} {{
+    int sets;
+
+    public int Set(int v) {{
+        sets = sets + 1;
+        value = v + sets;
+        return value;
+    }}
+
+    public int Get() {{
+        return value * 2;
+    }}
+}}
+
+class {negator} extends {cell} {{
+    int value;
+
+    public int Get() {{
+        return 0 - value;
+    }}
+}}
+"""
+
+def run_fuzz_tests(count, file_details, global_id):
+    seed = random.randrange(1 << 30)
+    print(colored(f"\nGenerating {count} random programs (seed {seed})...", Colors.GREEN))
+    rng = random.Random(seed)
+    folder = tempfile.mkdtemp(prefix='minijava_fuzz_')
+    for i in range(count):
+        with open(os.path.join(folder, f'Fuzz{i}.java'), 'w') as file:
+            file.write(generate_random_program(rng, f'Fuzz{i}'))
+    return run_differential_tests(folder, 'fuzz', file_details, global_id)
+
+def generate_large_program(rng, size):
+    # One main class followed by as many random classes as fit in 'size' bytes
+    parts = ["public class Bench {\n    public static void main(String[] a) {\n        System.out.println(new Fuzz0().Run(1));\n    }\n}\n"]
+    total = len(parts[0])
+    index = 0
+    while total < size:
+        program = generate_random_program(rng, 'Bench', f'Fuzz{index}')
+        body = program[program.index(f'class Fuzz{index} '):]
+        parts.append(body)
+        total += len(body)
+        index += 1
+    return '\n'.join(parts)
+
+def parse_time(file_path, flags, repeats):
+    # Best of several runs, as reported by the compiler itself so printing the tree is not counted
+    best = None
+    for _ in range(repeats):
+        _, stderr, _ = run_timed(['./compiler', file_path, '-parse-time'] + flags)
+        match = re.search(r'Parse time: ([0-9.e+-]+) ms', stderr)
+        if match:
+            best = float(match.group(1)) if best is None else min(best, float(match.group(1)))
+    return best
+
+def run_parse_benchmark(megabytes):
+    print(colored(f"\nGenerating a {megabytes} MB program...", Colors.GREEN))
+    rng = random.Random(megabytes)
+    folder = tempfile.mkdtemp(prefix='minijava_bench_')
+    file_path = os.path.join(folder, 'Bench.java')
+    with open(file_path, 'w') as file:
+        file.write(generate_large_program(rng, megabytes * 1024 * 1024))
+    size = os.path.getsize(file_path) / (1024 * 1024)
+
+    interleaved = parse_time(file_path, [], 3)
+    pipelined = parse_time(file_path, ['-pipeline'], 3)
+    if interleaved is None or pipelined is None:
+        print(colored("The benchmark program did not parse.", Colors.RED))
+        return
+    print(f"  interleaved lexer: {interleaved:.1f} ms ({size / interleaved * 1000:.1f} MB/s)")
+    print(f"  pipelined lexer:   {pipelined:.1f} ms ({size / pipelined * 1000:.1f} MB/s)")
+    print(f"  speedup {interleaved / pipelined:.2f}x")
+
+CALL_BENCHMARK = 'test_files/valid/RecursionBenchmark.java'
+
+def run_call_benchmark(repeats):
+    # The benchmark prints how many calls it made last. Best of several runs, timed by
+    # the evaluator itself so parsing and printing the tree are not counted.
+    print(colored(f"\nRunning {CALL_BENCHMARK} in the AST evaluator...", Colors.GREEN))
+    best = None
+    calls = 0
+    for _ in range(repeats):
+        stdout, stderr, _ = run_timed(['./compiler', CALL_BENCHMARK, '-run'])
+        match = re.search(r'Evaluation time: ([0-9.e+-]+) ms', stderr)
+        if 'Program output:\n' not in stdout or not match or 'Exception' in stderr:
+            print(colored("The benchmark did not run to completion.", Colors.RED))
+            return
+        calls = int(stdout.split('Program output:\n', 1)[1].split()[-1])
+        best = float(match.group(1)) if best is None else min(best, float(match.group(1)))
+    print(f"  {calls} calls in {best:.1f} ms ({calls / best / 1000:.2f} million calls/s)")
+
 def main():
     if len(sys.argv) < 2:
         print("Usage: python testScript.py [options]")
@@ -206,7 +474,12 @@ def main():
         print("  -syntax        Run tests in the 'test_files/syntax_errors' directory to detect syntactic errors.")
         print("  -semantic      Run tests in the 'test_files/semantic_errors' directory to validate semantic correctness.")
         print("  -valid         Run tests in the 'test_files/valid' directory to ensure valid files are processed correctly.")
+        print("  -semantic-valid Run the files in 'test_files/valid' with -semantic, none of them may report a semantic error.")
         print("  -interpreter   Run tests in the 'test_files/assignment3_valid' directory for interpreter-related functionality.")
+        print("  -differential  Check the native back end against the AST evaluator on the valid programs and report the speedup.")
+        print("  -fuzz N        Same as -differential on N randomly generated programs.")
+        print("  -benchmark N   Compare parse throughput with and without -pipeline on a generated N MB program.")
+        print("  -calls         Time the AST evaluator on the recursive Fibonacci and Factorial benchmark.")
         print("You can specify multiple options at once to run tests across different categories.")
         sys.exit(1)
     
@@ -223,10 +496,30 @@ def main():
     file_details = {}   
     summary_generated = False
 
-    for test_type in test_types:
-        if test_type in valid_types:
+    for index, test_type in enumerate(test_types):
+        if test_type == "-differential":
+            for folder in ("test_files/valid", "test_files/assignment3_valid"):
+                global_file_id = run_differential_tests(folder, "differential", file_details, global_file_id)
+            summary_generated = True
+        elif test_type == "-semantic-valid":
+            global_file_id = run_test_files("test_files/valid", "semantic-valid", file_details, global_file_id, ['-semantic'])
+            summary_generated = True
+        elif test_type == "-fuzz":
+            count = int(test_types[index + 1]) if index + 1 < len(test_types) and test_types[index + 1].isdigit() else 20
+            global_file_id = run_fuzz_tests(count, file_details, global_file_id)
+            summary_generated = True
+        elif test_type == "-benchmark":
+            megabytes = int(test_types[index + 1]) if index + 1 < len(test_types) and test_types[index + 1].isdigit() else 8
+            run_parse_benchmark(megabytes)
+        elif test_type == "-calls":
+            run_call_benchmark(3)
+        elif test_type.isdigit():
+            continue
+        elif test_type in valid_types:
             if test_type == "-interpreter":
                 global_file_id = run_interpreter_tests(valid_types[test_type], test_type[1:], file_details, global_file_id)
+            elif test_type == "-semantic":
+                global_file_id = run_test_files(valid_types[test_type], test_type[1:], file_details, global_file_id, ['-semantic'])
             else:
                 global_file_id = run_test_files(valid_types[test_type], test_type[1:], file_details, global_file_id)
             
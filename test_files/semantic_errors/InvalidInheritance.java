@@ -0,0 +1,33 @@
+public class InvalidInheritance {
+    public static void main(String[] a) {
+        System.out.println(new Shelter().run());
+    }
+}
+
+class Animal {
+    int legs;
+}
+
+class Dog extends Animal {
+    int tail;
+}
+
+class Robot extends Machine {
+    int bolts;
+}// @error - semantic (Parent class 'Machine' is not declared, reported at the end of the class)
+
+class Ping extends Pong {
+    int p;
+}// @error - semantic (Cyclic inheritance: 'Ping' -> 'Pong' -> 'Ping', reported at the end of the class)
+
+class Pong extends Ping {
+    int q;
+}
+
+class Shelter {
+    public int run() {
+        Dog d;
+        d = new Animal();// @error - semantic (Animal is not a subtype of Dog)
+        return 0;
+    }
+}
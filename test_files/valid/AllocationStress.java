@@ -0,0 +1,69 @@
+public class AllocationStress {
+    public static void main(String[] a) {
+        System.out.println(new Stress().Run(1000000, 100));
+    }
+}
+
+class Link {
+    int value;
+    Link next;
+
+    public int Init(int v, Link n) {
+        value = v;
+        next = n;
+        return v;
+    }
+
+    public int GetValue() {
+        return value;
+    }
+
+    public Link GetNext() {
+        return next;
+    }
+}
+
+class Stress {
+    Link kept;
+    int[] rounds;
+
+    public int Run(int nodes, int size) {
+        int built;
+        int total;
+        int i;
+        int r;
+        Link head;
+        Link link;
+        rounds = new int[1];
+        kept = new Link();
+        r = kept.Init(0, kept);
+        built = 0;
+        total = 0;
+        while (built < nodes) {
+            head = new Link();
+            r = head.Init(0, head);
+            i = 1;
+            while (i < size + 1) {
+                link = new Link();
+                r = link.Init(i, head);
+                head = link;
+                i = i + 1;
+            }
+            total = total + this.Sum(head, size);
+            rounds[0] = rounds[0] + 1;
+            built = built + size;
+        }
+        return total + this.Sum(kept, 1) + rounds[0];
+    }
+
+    public int Sum(Link list, int count) {
+        int sum;
+        sum = 0;
+        while (0 < count) {
+            sum = sum + list.GetValue();
+            list = list.GetNext();
+            count = count - 1;
+        }
+        return sum;
+    }
+}
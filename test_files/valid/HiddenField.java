@@ -0,0 +1,47 @@
+public class HiddenField {
+    public static void main(String[] a) {
+        System.out.println(new User().Start());
+    }
+}
+
+class Base {
+    int v;
+
+    public int Init() {
+        v = 1;
+        return 0;
+    }
+
+    public int GetV() {
+        return v;
+    }
+}
+
+// Declares its own 'v', methods of Base still see the one in Base
+class Derived extends Base {
+    int v;
+
+    public int InitDerived() {
+        v = 2;
+        return 0;
+    }
+
+    public int Both() {
+        return this.GetV() * 10 + v;
+    }
+}
+
+class User {
+    public int Start() {
+        Derived d;
+        Base b;
+        int r;
+        d = new Derived();
+        r = d.Init();
+        r = d.InitDerived();
+        b = d;
+        System.out.println(d.GetV());
+        System.out.println(b.GetV());
+        return d.Both();
+    }
+}
@@ -0,0 +1,31 @@
+public class InlineNullReceiver {
+    public static void main(String[] a) {
+        System.out.println(new Holder().Start());
+    }
+}
+
+class Constant {
+    int value;
+
+    public int Five() {
+        return 5;
+    }
+
+    public int Get() {
+        return value;
+    }
+}
+
+class Holder {
+    Constant k;
+
+    public int Start() {
+        Constant local;
+        local = new Constant();
+        System.out.println(local.Get());
+        System.out.println(new Constant().Five());
+        // 'k' was never assigned: both calls must throw, inlined or not
+        System.out.println(k.Get());
+        return k.Five();
+    }
+}
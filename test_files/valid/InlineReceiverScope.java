@@ -0,0 +1,35 @@
+public class InlineReceiverScope {
+    public static void main(String[] a) {
+        System.out.println(new M().Start());
+    }
+}
+
+class Foo {
+    public int Get() {
+        return 1;
+    }
+}
+
+class Bar {
+    public int Get() {
+        return 2;
+    }
+}
+
+class M {
+    public int A() {
+        Foo x;
+        x = new Foo();
+        return x.Get();
+    }
+
+    // The 'x' here is a Bar, not the Foo declared first in A
+    public int B(Bar x) {
+        return x.Get();
+    }
+
+    public int Start() {
+        System.out.println(this.A());
+        return this.B(new Bar());
+    }
+}
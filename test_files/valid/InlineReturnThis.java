@@ -0,0 +1,34 @@
+public class InlineReturnThis {
+    public static void main(String[] a) {
+        System.out.println(new Owner().Start());
+    }
+}
+
+class Box {
+    int value;
+
+    public Box Self() {
+        return this;
+    }
+
+    public int Set(int v) {
+        value = v;
+        return v;
+    }
+
+    public int Get() {
+        return value;
+    }
+}
+
+class Owner {
+    public int Start() {
+        Box b;
+        Box c;
+        int r;
+        b = new Box();
+        r = b.Set(7);
+        c = b.Self();
+        return c.Get();
+    }
+}
@@ -0,0 +1,20 @@
+public class InlineThrowingArgument {
+    public static void main(String[] a) {
+        System.out.println(new Caller().Start());
+    }
+}
+
+class Caller {
+    int[] arr;
+
+    public int Const(int unused) {
+        return 5;
+    }
+
+    public int Start() {
+        arr = new int[10];
+        System.out.println(this.Const(arr[9]));
+        // The argument is evaluated, and throws, even though Const ignores it
+        return this.Const(arr[100]);
+    }
+}
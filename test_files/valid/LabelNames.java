@@ -0,0 +1,25 @@
+public class LabelNames {
+    public static void main(String[] a) {
+        System.out.println(new vt().vtable());
+    }
+}
+
+class vt {
+    public int vtable() {
+        return new Pair().Sum(3);
+    }
+
+    public int Pair() {
+        return 4;
+    }
+}
+
+class Pair extends vt {
+    public int vtable() {
+        return 5;
+    }
+
+    public int Sum(int x) {
+        return x + this.vtable() + this.Pair();
+    }
+}
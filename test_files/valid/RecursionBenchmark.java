@@ -0,0 +1,45 @@
+public class RecursionBenchmark {
+    public static void main(String[] a) {
+        System.out.println(new Calls().Run(25, 2000, 500000));
+    }
+}
+
+class Calls {
+    int calls;
+
+    public int Run(int fib, int rounds, int depth) {
+        int round;
+        int total;
+        calls = 0;
+        System.out.println(this.Fib(fib));
+        round = 0;
+        total = 0;
+        while (round < rounds) {
+            total = total + this.Fac(12);
+            round = round + 1;
+        }
+        System.out.println(total);
+        System.out.println(this.Fac(depth));
+        return calls;
+    }
+
+    public int Fib(int n) {
+        int result;
+        calls = calls + 1;
+        if (n < 2)
+            result = n;
+        else
+            result = this.Fib(n - 1) + this.Fib(n - 2);
+        return result;
+    }
+
+    public int Fac(int n) {
+        int result;
+        calls = calls + 1;
+        if (n < 1)
+            result = 1;
+        else
+            result = n * this.Fac(n - 1);
+        return result;
+    }
+}
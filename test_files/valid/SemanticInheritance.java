@@ -0,0 +1,47 @@
+public class SemanticInheritance {
+    public static void main(String[] a) {
+        System.out.println(new Zoo().run());
+    }
+}
+
+class Animal {
+    int legs;
+
+    public int GetLegs() {
+        return legs;
+    }
+}
+
+class Dog extends Animal {
+    public int Bark() {
+        return 1;
+    }
+}
+
+class Puppy extends Dog {
+    public int Play() {
+        return 2;
+    }
+}
+
+class Zoo {
+    Animal pet;
+
+    public Animal Adopt(Animal other) {
+        return other;
+    }
+
+    public Animal Newest() {
+        return new Puppy();
+    }
+
+    public int run() {
+        Puppy p;
+        Dog d;
+        p = new Puppy();
+        d = p;
+        pet = d;
+        pet = this.Adopt(p);
+        return 0;
+    }
+}
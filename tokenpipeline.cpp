@@ -0,0 +1,211 @@
+#include "tokenpipeline.h"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+extern int yylineno;
+extern int lexical_errors;
+
+int tokenLine = 1;
+
+namespace {
+
+// Tokens in flight between the scanner and the parser, a power of two
+const size_t TOKEN_RING_SIZE = 4096;
+
+// A scanned token as it crosses to the parser thread
+struct Token {
+    yy::parser::symbol_kind_type kind;
+    int line;
+    const std::string* text;   // Identifiers and literals only, see internText
+    std::string* errors;       // Lexical errors reported since the previous token, owned by the reader
+};
+
+// Single-producer/single-consumer ring. The scanner thread only writes 'tail'
+// and the parser thread only writes 'head', so no locks are needed: a slot is
+// published by the release store to 'tail' and freed by the one to 'head'.
+// Each side keeps its last view of the other's index and only reloads it when
+// the ring looks full or empty, so the shared cache lines move once per batch
+// rather than once per token.
+class TokenRing {
+public:
+    // Empties the ring for a new run, only while no scanner thread is using it
+    void reset() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        stopped.store(false, std::memory_order_relaxed);
+        cachedHead = cachedTail = 0;
+    }
+
+    // Called by the scanner thread. Returns false if the reader asked to stop.
+    bool push(const Token& token) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        while (position - cachedHead == TOKEN_RING_SIZE) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead < TOKEN_RING_SIZE) break;
+            if (stopped.load(std::memory_order_acquire)) return false;
+            std::this_thread::yield();
+        }
+        slots[position & (TOKEN_RING_SIZE - 1)] = token;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Called by the parser thread, waits for the scanner if the ring is empty
+    Token pop() {
+        size_t position = head.load(std::memory_order_relaxed);
+        while (cachedTail == position) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (cachedTail != position) break;
+            std::this_thread::yield();
+        }
+        Token token = slots[position & (TOKEN_RING_SIZE - 1)];
+        head.store(position + 1, std::memory_order_release);
+        return token;
+    }
+
+    void stop() {
+        stopped.store(true, std::memory_order_release);
+    }
+
+    bool isStopped() const {
+        return stopped.load(std::memory_order_acquire);
+    }
+
+    // Frees what the parser never took, only once the scanner thread has finished
+    void drain() {
+        size_t end = tail.load(std::memory_order_acquire);
+        for (size_t position = head.load(std::memory_order_relaxed); position != end; position++) {
+            delete slots[position & (TOKEN_RING_SIZE - 1)].errors;
+        }
+        head.store(end, std::memory_order_release);
+    }
+
+private:
+    Token slots[TOKEN_RING_SIZE];
+    // Kept on separate cache lines so the two threads do not contend on them
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;   // Parser thread only
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;   // Scanner thread only
+    alignas(64) std::atomic<bool> stopped{false};
+};
+
+// Static rather than from operator new, which only honours the alignas above from C++17 on
+TokenRing tokenRing;
+TokenRing* ring = nullptr;   // Points to tokenRing while the pipeline runs
+std::thread scanner;
+
+// Written only by the scanner, which runs on the scanner thread while the pipeline
+// does. Elements never move, so the parser can read them through the tokens.
+std::unordered_set<std::string> internedText;
+
+// Scanner thread state
+std::string pendingErrors;
+
+// Set once the parser has taken the end of input, which the scanner sends only once
+bool reachedEnd = false;
+
+// Maps a symbol kind back to the token number the symbol_type constructors take
+std::vector<int> tokenNumbers;
+
+void buildTokenNumbers() {
+    tokenNumbers.assign(yy::parser::YYNTOKENS, 0);
+    // Token 0 is the end of input, the others are numbered from 256 on in declaration order
+    for (int token = 256; token < 256 + yy::parser::YYNTOKENS - 1; token++) {
+        tokenNumbers[yy::parser::by_kind(yy::parser::token_kind_type(token)).kind()] = token;
+    }
+}
+
+void printLexicalErrors(const std::string& errors) {
+    if (!lexical_errors) fprintf(stderr, "Lexical errors found! See the logs below: \n");
+    fputs(errors.c_str(), stderr);
+    lexical_errors = 1;
+}
+
+void scanAhead() {
+    for (;;) {
+        yy::parser::symbol_type symbol = scanToken();
+        Token token{symbol.kind(), yylineno, nullptr, nullptr};
+        if (symbol.kind() == yy::parser::symbol_kind::S_IDENTIFIER ||
+            symbol.kind() == yy::parser::symbol_kind::S_INTEGER_LITERAL) {
+            token.text = symbol.value.as<const std::string*>();
+        }
+        if (!pendingErrors.empty()) {
+            token.errors = new std::string(std::move(pendingErrors));
+            pendingErrors.clear();
+        }
+        if (!ring->push(token)) {
+            delete token.errors;
+            return;
+        }
+        if (token.kind == yy::parser::symbol_kind::S_YYEOF || ring->isStopped()) return;
+    }
+}
+
+} // namespace
+
+const std::string* internText(const char* text) {
+    return &*internedText.insert(text).first;
+}
+
+void lexicalError(int line, const char* text) {
+    std::string error = "\t@error at line " + std::to_string(line) + ". Character " + text + " is not recognized\n";
+    if (ring) {
+        pendingErrors += error;
+    } else {
+        printLexicalErrors(error);
+    }
+}
+
+yy::parser::symbol_type yylex() {
+    if (!ring) {
+        yy::parser::symbol_type symbol = scanToken();
+        tokenLine = yylineno;
+        return symbol;
+    }
+
+    // The grammar reads END itself and then asks for the end of input again,
+    // as the scanner would keep returning it
+    if (reachedEnd) {
+        return yy::parser::make_END();
+    }
+
+    Token token = ring->pop();
+    if (token.errors) {
+        printLexicalErrors(*token.errors);
+        delete token.errors;
+    }
+    tokenLine = token.line;
+    if (token.kind == yy::parser::symbol_kind::S_YYEOF) {
+        reachedEnd = true;
+    }
+    if (!token.text) {
+        return yy::parser::symbol_type(tokenNumbers[token.kind]);
+    }
+    return yy::parser::symbol_type(tokenNumbers[token.kind], token.text);
+}
+
+void startTokenPipeline() {
+    // On a single core the scanner thread cannot run alongside the parser, it would only add the hand-off
+    if (ring || std::thread::hardware_concurrency() == 1) return;
+    buildTokenNumbers();
+    tokenRing.reset();
+    ring = &tokenRing;
+    scanner = std::thread(scanAhead);
+}
+
+void stopTokenPipeline() {
+    if (!ring) return;
+    // The parser may stop early on a syntax error. Whatever was scanned past that
+    // point is dropped, lexical errors included, as the parser never asked for it.
+    ring->stop();
+    scanner.join();
+    ring->drain();
+    ring = nullptr;
+    pendingErrors.clear();
+    reachedEnd = false;
+}
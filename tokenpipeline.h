@@ -0,0 +1,29 @@
+#ifndef TOKENPIPELINE_H
+#define TOKENPIPELINE_H
+
+#include "parser.tab.hh"
+
+// The flex scanner. The parser does not call it directly but through yylex(),
+// which either scans on the calling thread or takes the next token from the
+// scanner thread when the pipeline is running.
+yy::parser::symbol_type scanToken();
+yy::parser::symbol_type yylex();
+
+// Line of the token most recently handed to the parser, used for AST nodes and syntax errors
+extern int tokenLine;
+
+// The single copy of an identifier's or integer literal's text, which is what
+// those tokens carry. It stays valid for the rest of the run.
+const std::string* internText(const char* text);
+
+// Reports an unrecognized character. With the pipeline running the report is
+// held back until the parser takes the next token, so lexical and syntax
+// errors come out in the same order and under the same conditions as without it.
+void lexicalError(int line, const char* text);
+
+// Runs the scanner on its own thread, ahead of the parser. Must be started
+// after yyin is set and stopped once parsing is done, even if it failed.
+void startTokenPipeline();
+void stopTokenPipeline();
+
+#endif // TOKENPIPELINE_H